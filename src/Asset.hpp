@@ -1,6 +1,8 @@
 #ifndef __ASSET_HPP__
 #define __ASSET_HPP__
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 
 #ifndef SDL_MAIN_HANDLED
@@ -12,13 +14,13 @@
 
 #include "nlohmann/json.hpp"
 
+#include "AssetTypes.hpp"
 #include "Color.hpp"
 #include "Templates.hpp"
+#include "Types.hpp"
 
 namespace DarkEmperor::Asset
 {
-    const int NONE = -1;
-
     // load an image as an SDL surface
     SDL_Surface *Load(const char *image)
     {
@@ -43,6 +45,9 @@ namespace DarkEmperor::Asset
         }
     }
 
+    // incremented whenever a texture is freed (anything keyed by texture address must be discarded)
+    unsigned int Generation = 0;
+
     // free texture
     void Free(SDL_Texture **texture)
     {
@@ -51,6 +56,8 @@ namespace DarkEmperor::Asset
             SDL_DestroyTexture(*texture);
 
             *texture = nullptr;
+
+            Asset::Generation++;
         }
     }
 
@@ -80,6 +87,21 @@ namespace DarkEmperor::Asset
         return height;
     }
 
+    // create texture from a surface
+    SDL_Texture *Create(SDL_Renderer *renderer, SDL_Surface *surface)
+    {
+        auto texture = SDL_CreateTextureFromSurface(renderer, surface);
+
+        if (texture)
+        {
+            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+            SDL_SetTextureColorMod(texture, Color::R(Color::Active), Color::G(Color::Active), Color::B(Color::Active));
+        }
+
+        return texture;
+    }
+
     // create texture from a file
     SDL_Texture *Create(SDL_Renderer *renderer, const char *path)
     {
@@ -89,43 +111,115 @@ namespace DarkEmperor::Asset
 
         if (surface)
         {
-            texture = SDL_CreateTextureFromSurface(renderer, surface);
+            texture = Asset::Create(renderer, surface);
+
+            Asset::Free(&surface);
+        }
+
+        return texture;
+    }
+
+    // area of a texture holding an asset (assets are packed into a few large textures, see LoadTextures)
+    class Handle
+    {
+    public:
+        SDL_Texture *Texture = nullptr;
+
+        // location of the asset in the texture
+        Point Location = Point(0, 0);
+
+        Point Dimensions = Point(0, 0);
+
+        Handle(SDL_Texture *texture, Point location, Point dimensions) : Texture(texture), Location(location), Dimensions(dimensions) {}
+
+        Handle() {}
+    };
+
+    // packs rectangles row by row (on shelves) into a larger rectangle
+    class Shelf
+    {
+    public:
+        Point Dimensions = Point(0, 0);
+
+        // next free location on the current shelf
+        Point Cursor = Point(0, 0);
+
+        // height of the current shelf
+        int Height = 0;
+
+        // space between rectangles
+        int Padding = 1;
+
+        Shelf(Point dimensions, Point start) : Dimensions(dimensions), Cursor(start) {}
+
+        Shelf(Point dimensions) : Dimensions(dimensions) {}
+
+        Shelf() {}
+
+        // reserve an area. returns false if there is no space left
+        bool Pack(Point dimensions, Point &location)
+        {
+            // start a new shelf
+            if (this->Cursor.X + dimensions.X > this->Dimensions.X)
+            {
+                this->Cursor = Point(0, this->Cursor.Y + this->Height);
 
-            if (texture)
+                this->Height = 0;
+            }
+
+            auto packed = dimensions.X <= this->Dimensions.X && this->Cursor.Y + dimensions.Y <= this->Dimensions.Y;
+
+            if (packed)
             {
-                SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+                location = this->Cursor;
 
-                SDL_SetTextureColorMod(texture, Color::R(Color::Active), Color::G(Color::Active), Color::B(Color::Active));
+                this->Cursor.X += dimensions.X + this->Padding;
+
+                this->Height = std::max(this->Height, dimensions.Y + this->Padding);
             }
 
-            Asset::Free(&surface);
+            return packed;
         }
+    };
 
-        return texture;
-    }
+    // size of the textures (pages) assets are packed into
+    int PageSize = 2048;
+
+    // size of the white area at the top-left corner of every page (used to draw solid shapes in the same batch as assets)
+    const int Blank = 2;
 
-    UnorderedMap<int, SDL_Texture *> Textures = {};
+    // textures holding the packed assets
+    List<SDL_Texture *> Pages = {};
+
+    // textures of assets too large for a page
+    List<SDL_Texture *> Textures = {};
+
+    UnorderedMap<int, Asset::Handle> Handles = {};
 
     UnorderedMap<std::string, int> Ids = {};
 
-    template <typename T, typename R>
-    void Free(UnorderedMap<T, R> &resources)
+    // check if texture is a page of packed assets
+    bool IsPage(SDL_Texture *texture)
     {
-        if (!resources.empty())
+        auto found = false;
+
+        for (auto page : Asset::Pages)
         {
-            for (auto &resource : resources)
+            if (page == texture)
             {
-                Asset::Free(&resource.second);
-            }
+                found = true;
 
-            resources.clear();
+                break;
+            }
         }
+
+        return found;
     }
 
-    // retrieve texture based on numeric id
-    SDL_Texture *Get(int asset)
+    // retrieve texture (and location within it) based on numeric id
+    Asset::Handle Get(int asset)
     {
-        return DarkEmperor::Has(Asset::Textures, asset) ? Asset::Textures[asset] : nullptr;
+        return DarkEmperor::Has(Asset::Handles, asset) ? Asset::Handles[asset] : Asset::Handle();
     }
 
     // retrieve texture numeric id based on string id
@@ -134,23 +228,55 @@ namespace DarkEmperor::Asset
         return DarkEmperor::Has(Asset::Ids, asset) ? Asset::Ids[asset] : NONE;
     }
 
-    // retrieve texture based on string id
-    SDL_Texture *Get(std::string asset)
+    // retrieve texture (and location within it) based on string id
+    Asset::Handle Get(std::string asset)
     {
-        return DarkEmperor::Has(Asset::Ids, asset) ? Asset::Get(Asset::Id(asset)) : nullptr;
+        return DarkEmperor::Has(Asset::Ids, asset) ? Asset::Get(Asset::Id(asset)) : Asset::Handle();
     }
 
     // clears (frees) all textures
     void ClearTextures()
     {
         // LOG
-        std::cerr << "Unloading " << Asset::Textures.size() << " texture(s) ..." << std::endl;
+        std::cerr << "Unloading " << Asset::Handles.size() << " image(s) from " << (Asset::Pages.size() + Asset::Textures.size()) << " texture(s) ..." << std::endl;
+
+        for (auto &page : Asset::Pages)
+        {
+            Asset::Free(&page);
+        }
+
+        for (auto &texture : Asset::Textures)
+        {
+            Asset::Free(&texture);
+        }
+
+        Asset::Pages.clear();
+
+        Asset::Textures.clear();
 
-        Asset::Free(Asset::Textures);
+        Asset::Handles.clear();
 
         Asset::Ids.clear();
     }
 
+    // new page (transparent, except for the white area at the top-left corner)
+    SDL_Surface *Page()
+    {
+        auto page = SDL_CreateRGBSurfaceWithFormat(0, Asset::PageSize, Asset::PageSize, 32, SDL_PIXELFORMAT_RGBA32);
+
+        if (page)
+        {
+            SDL_FillRect(page, nullptr, 0);
+
+            auto blank = SDL_Rect{0, 0, Asset::Blank, Asset::Blank};
+
+            SDL_FillRect(page, &blank, 0xFFFFFFFF);
+        }
+
+        return page;
+    }
+
+    // load the images listed in assets and pack them into as few textures (pages) as possible
     void LoadTextures(SDL_Renderer *renderer, const char *assets)
     {
         Asset::ClearTextures();
@@ -164,10 +290,11 @@ namespace DarkEmperor::Asset
 
             auto data = nlohmann::json::parse(ifs);
 
+            // images (indexed by asset id)
+            auto surfaces = List<SDL_Surface *>();
+
             if (!data["assets"].is_null() && data["assets"].is_array() && data["assets"].size() > 0)
             {
-                auto id = 0;
-
                 for (auto i = 0; i < data["assets"].size(); i++)
                 {
                     auto asset = !data["assets"][i]["id"].is_null() ? std::string(data["assets"][i]["id"]) : "";
@@ -176,15 +303,13 @@ namespace DarkEmperor::Asset
 
                     if (!asset.empty() && !path.empty())
                     {
-                        auto texture = Asset::Create(renderer, path.c_str());
+                        auto surface = Asset::Load(path.c_str());
 
-                        if (texture != nullptr)
+                        if (surface != nullptr)
                         {
-                            Asset::Ids[asset] = id;
-
-                            Asset::Textures[id] = texture;
+                            Asset::Ids[asset] = int(surfaces.size());
 
-                            id++;
+                            surfaces.push_back(surface);
                         }
                     }
                 }
@@ -192,8 +317,95 @@ namespace DarkEmperor::Asset
 
             ifs.close();
 
+            // pack the tallest images first
+            auto order = List<int>();
+
+            for (auto id = 0; id < surfaces.size(); id++)
+            {
+                order.push_back(id);
+            }
+
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b)
+                             { return surfaces[a]->h > surfaces[b]->h; });
+
+            auto pages = List<SDL_Surface *>();
+
+            auto shelf = Asset::Shelf();
+
+            // page of each image (-1 if it has its own texture) and its location in the page
+            auto packed = List<int>(surfaces.size(), -1);
+
+            auto locations = Points(surfaces.size(), Point(0, 0));
+
+            for (auto id : order)
+            {
+                auto &surface = surfaces[id];
+
+                auto dimensions = Point(surface->w, surface->h);
+
+                if (dimensions.X <= Asset::PageSize && dimensions.Y <= Asset::PageSize)
+                {
+                    auto fits = !pages.empty() && shelf.Pack(dimensions, locations[id]);
+
+                    if (!fits)
+                    {
+                        auto page = Asset::Page();
+
+                        if (page)
+                        {
+                            pages.push_back(page);
+
+                            // start after the white area
+                            shelf = Asset::Shelf(Point(Asset::PageSize, Asset::PageSize), Point(Asset::Blank + 1, 0));
+
+                            shelf.Height = Asset::Blank + shelf.Padding;
+
+                            fits = shelf.Pack(dimensions, locations[id]);
+                        }
+                    }
+
+                    if (fits)
+                    {
+                        auto destination = SDL_Rect{locations[id].X, locations[id].Y, dimensions.X, dimensions.Y};
+
+                        // copy the image as is (including alpha)
+                        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+
+                        SDL_BlitSurface(surface, nullptr, pages.back(), &destination);
+
+                        packed[id] = int(pages.size()) - 1;
+                    }
+                }
+            }
+
+            for (auto &page : pages)
+            {
+                Asset::Pages.push_back(Asset::Create(renderer, page));
+
+                Asset::Free(&page);
+            }
+
+            for (auto id = 0; id < surfaces.size(); id++)
+            {
+                auto dimensions = Point(surfaces[id]->w, surfaces[id]->h);
+
+                if (packed[id] >= 0)
+                {
+                    Asset::Handles[id] = Asset::Handle(Asset::Pages[packed[id]], locations[id], dimensions);
+                }
+                else
+                {
+                    // image is too large for a page
+                    Asset::Textures.push_back(Asset::Create(renderer, surfaces[id]));
+
+                    Asset::Handles[id] = Asset::Handle(Asset::Textures.back(), Point(0, 0), dimensions);
+                }
+
+                Asset::Free(&surfaces[id]);
+            }
+
             // LOG
-            std::cerr << "Loaded " << Asset::Textures.size() << " image(s) ..." << std::endl;
+            std::cerr << "Loaded " << Asset::Handles.size() << " image(s) into " << (Asset::Pages.size() + Asset::Textures.size()) << " texture(s) ..." << std::endl;
         }
     }
 
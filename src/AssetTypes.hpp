@@ -0,0 +1,9 @@
+#ifndef __ASSET_TYPES_HPP__
+#define __ASSET_TYPES_HPP__
+
+namespace DarkEmperor::Asset
+{
+    const int NONE = -1;
+}
+
+#endif
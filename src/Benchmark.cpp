@@ -0,0 +1,753 @@
+#include <chrono>
+#include <iostream>
+
+#include "Game.hpp"
+#include "Hierarchy.hpp"
+#include "MoveLegacy.hpp"
+#include "Utilities.hpp"
+
+namespace DarkEmperor::Benchmark
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    // elapsed time in milliseconds
+    double Elapsed(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // generate a random map with terrain, attrition and occupied tiles
+    void Generate(Map &map, Units &units, Random::Base &random)
+    {
+        // terrain distribution (roughly that of Loslon)
+        const List<TerrainType> terrains = {
+            TerrainType::SEA, TerrainType::SEA, TerrainType::SEA,
+            TerrainType::SETTLED, TerrainType::SETTLED, TerrainType::SETTLED, TerrainType::SETTLED,
+            TerrainType::MOUNTAIN, TerrainType::MOUNTAIN,
+            TerrainType::RIVER,
+            TerrainType::COASTAL, TerrainType::COASTAL,
+            TerrainType::CITY,
+            TerrainType::PORT,
+            TerrainType::HOLY_PLACE,
+            TerrainType::MAGIC_HEX};
+
+        for (auto y = 0; y < map.Dimensions.Y; y++)
+        {
+            for (auto x = 0; x < map.Dimensions.X; x++)
+            {
+                auto &tile = map(x, y);
+
+                tile.Terrain = terrains[random.NextInt(0, int(terrains.size()) - 1)];
+
+                tile.StackLimit = DarkEmperor::StackLimit(tile.Terrain);
+
+                tile.Attrition = (tile.Terrain == TerrainType::MOUNTAIN ? 2 : (tile.Terrain == TerrainType::RIVER ? 1 : 0));
+
+                tile.CityValue = tile.IsCity() ? random.NextInt(1, 3) : 0;
+
+                tile.Owner = Kingdom(random.NextInt(0, int(Kingdom::ZOLAHAURESLOR)));
+            }
+        }
+
+        map.Synchronize();
+
+        // occupy roughly one in ten tiles
+        for (auto i = 0; i < map.Dimensions.X * map.Dimensions.Y / 10; i++)
+        {
+            auto point = Point(random.NextInt(0, map.Dimensions.X - 1), random.NextInt(0, map.Dimensions.Y - 1));
+
+            auto kingdom = Kingdom(random.NextInt(0, int(Kingdom::ZOLAHAURESLOR)));
+
+            auto type = map[point].Terrain == TerrainType::SEA ? UnitType::NAVAL : UnitType::GROUND;
+
+            units.push_back(Unit::Base(Unit::Base(type, kingdom, 1, 1, Asset::NONE, "Benchmark"), int(units.size())));
+
+            map.Put(units.back(), point);
+        }
+    }
+
+    // total cost of traversing the path
+    int Cost(Map &map, Move::Path &path)
+    {
+        auto cost = 0;
+
+        for (auto i = 1; i < path.Points.size(); i++)
+        {
+            cost += Move::Cost(map, path.Points[i]);
+        }
+
+        return cost;
+    }
+
+    // check if both paths visit the same tiles and have the same closest point
+    bool Same(Move::Path &a, Move::Path &b)
+    {
+        auto same = a.Points.size() == b.Points.size() && a.Closest == b.Closest;
+
+        for (auto i = 0; same && i < a.Points.size(); i++)
+        {
+            same = (a.Points[i] == b.Points[i]);
+        }
+
+        return same;
+    }
+
+    // compare list-based and heap-based A* on random queries
+    void Paths(int width, int height, int queries, int seed)
+    {
+        auto random = Random::Base(seed);
+
+        auto map = Map(width, height, 54, true);
+
+        auto units = Units();
+
+        Benchmark::Generate(map, units, random);
+
+        auto stack = Stack{{-1, UnitType::GROUND, Kingdom::NONE, Mercenary::NONE}, {-1, UnitType::GROUND, Kingdom::NONE, Mercenary::NONE}};
+
+        auto sources = Points();
+
+        auto destinations = Points();
+
+        for (auto i = 0; i < queries; i++)
+        {
+            sources.push_back(Point(random.NextInt(0, width - 1), random.NextInt(0, height - 1)));
+
+            destinations.push_back(Point(random.NextInt(0, width - 1), random.NextInt(0, height - 1)));
+        }
+
+        auto legacy = List<Move::Path>();
+
+        auto start = Benchmark::Clock::now();
+
+        for (auto i = 0; i < queries; i++)
+        {
+            legacy.push_back(Move::FindPathLegacy(map, sources[i], destinations[i], stack));
+        }
+
+        auto legacy_time = Benchmark::Elapsed(start);
+
+        auto paths = List<Move::Path>();
+
+        start = Benchmark::Clock::now();
+
+        for (auto i = 0; i < queries; i++)
+        {
+            paths.push_back(Move::FindPath(map, sources[i], destinations[i], stack));
+        }
+
+        auto heap_time = Benchmark::Elapsed(start);
+
+        auto workspace = Move::Workspace(map);
+
+        auto reused = Move::Path();
+
+        auto reused_mismatches = 0;
+
+        start = Benchmark::Clock::now();
+
+        for (auto i = 0; i < queries; i++)
+        {
+            Move::FindPath(map, sources[i], destinations[i], stack, workspace, reused);
+
+            reused_mismatches += (reused.Points.size() != paths[i].Points.size() ? 1 : 0);
+        }
+
+        auto workspace_time = Benchmark::Elapsed(start);
+
+        auto requests = Move::Requests();
+
+        for (auto i = 0; i < queries; i++)
+        {
+            requests.push_back(Move::Request(sources[i], destinations[i], stack));
+        }
+
+        auto pool = Pool::Base();
+
+        auto workspaces = List<Move::Workspace>();
+
+        start = Benchmark::Clock::now();
+
+        auto batch = Move::FindPaths(map, requests, pool, workspaces);
+
+        auto parallel_time = Benchmark::Elapsed(start);
+
+        for (auto i = 0; i < queries; i++)
+        {
+            reused_mismatches += (batch[i].Points.size() != paths[i].Points.size() ? 1 : 0);
+        }
+
+        auto table_time = 0.0;
+
+        auto table = map.PrecomputeDistances();
+
+        if (table)
+        {
+            start = Benchmark::Clock::now();
+
+            for (auto i = 0; i < queries; i++)
+            {
+                Move::FindPath(map, sources[i], destinations[i], stack, workspace, reused);
+
+                reused_mismatches += (reused.Points.size() != paths[i].Points.size() ? 1 : 0);
+            }
+
+            table_time = Benchmark::Elapsed(start);
+        }
+
+        auto found = 0;
+
+        auto mismatches = 0;
+
+        for (auto i = 0; i < queries; i++)
+        {
+            if (legacy[i].Points.size() > 0)
+            {
+                found++;
+            }
+
+            if (legacy[i].Points.empty() != paths[i].Points.empty() || Benchmark::Cost(map, legacy[i]) != Benchmark::Cost(map, paths[i]))
+            {
+                mismatches++;
+            }
+            else if (legacy[i].Points.empty() && map.Distance(legacy[i].Closest, destinations[i]) != map.Distance(paths[i].Closest, destinations[i]))
+            {
+                mismatches++;
+            }
+        }
+
+        std::cerr << "Map: " << width << "x" << height << ", queries: " << queries << ", paths found: " << found << std::endl;
+
+        std::cerr << "List A*: " << legacy_time << " ms (" << legacy_time / queries << " ms/query)" << std::endl;
+
+        std::cerr << "Heap A*: " << heap_time << " ms (" << heap_time / queries << " ms/query)" << std::endl;
+
+        std::cerr << "Heap A* (workspace): " << workspace_time << " ms (" << workspace_time / queries << " ms/query)" << std::endl;
+
+        if (table)
+        {
+            std::cerr << "Heap A* (distance table): " << table_time << " ms (" << table_time / queries << " ms/query)" << std::endl;
+        }
+
+        std::cerr << "Heap A* (" << pool.Workers() << " workers): " << parallel_time << " ms (" << parallel_time / queries << " ms/query)" << std::endl;
+
+        std::cerr << "Speedup: " << (heap_time > 0.0 ? legacy_time / heap_time : 0.0) << "x, " << (workspace_time > 0.0 ? legacy_time / workspace_time : 0.0) << "x (workspace), " << (parallel_time > 0.0 ? legacy_time / parallel_time : 0.0) << "x (parallel), mismatches: " << (mismatches + reused_mismatches) << std::endl;
+    }
+
+    // compare A* with hierarchical path finding on a large map, before and after changes to the map. returns the number of
+    // queries where only one of them found a path
+    int Hierarchy(int width, int height, int queries, int seed)
+    {
+        auto random = Random::Base(seed);
+
+        auto map = Map(width, height, 54, true);
+
+        auto units = Units();
+
+        Benchmark::Generate(map, units, random);
+
+        auto stack = Stack{{-1, UnitType::GROUND, Kingdom::NONE, Mercenary::NONE}, {-1, UnitType::GROUND, Kingdom::NONE, Mercenary::NONE}};
+
+        auto sources = Points();
+
+        auto destinations = Points();
+
+        for (auto i = 0; i < queries; i++)
+        {
+            sources.push_back(Point(random.NextInt(0, width - 1), random.NextInt(0, height - 1)));
+
+            destinations.push_back(Point(random.NextInt(0, width - 1), random.NextInt(0, height - 1)));
+        }
+
+        auto workspace = Move::Workspace(map);
+
+        auto hierarchy = Hierarchy::Base();
+
+        auto path = Move::Path();
+
+        auto abstract = Move::Path();
+
+        auto total_mismatches = 0;
+
+        for (auto round = 0; round < 2; round++)
+        {
+            auto search_time = 0.0;
+
+            auto hierarchy_time = 0.0;
+
+            auto found = 0;
+
+            auto mismatches = 0;
+
+            auto costs = 0.0;
+
+            auto abstract_costs = 0.0;
+
+            // the first query of the first round also builds the abstract graph
+            auto start = Benchmark::Clock::now();
+
+            hierarchy.FindPath(map, sources[0], destinations[0], stack, abstract);
+
+            auto build_time = Benchmark::Elapsed(start);
+
+            for (auto i = 0; i < queries; i++)
+            {
+                start = Benchmark::Clock::now();
+
+                Move::FindPath(map, sources[i], destinations[i], stack, workspace, path);
+
+                search_time += Benchmark::Elapsed(start);
+
+                start = Benchmark::Clock::now();
+
+                hierarchy.FindPath(map, sources[i], destinations[i], stack, abstract);
+
+                hierarchy_time += Benchmark::Elapsed(start);
+
+                if (path.Points.empty() != abstract.Points.empty())
+                {
+                    mismatches++;
+                }
+                else if (!path.Points.empty())
+                {
+                    found++;
+
+                    costs += Benchmark::Cost(map, path);
+
+                    abstract_costs += Benchmark::Cost(map, abstract);
+                }
+            }
+
+            std::cerr << "Map: " << width << "x" << height << ", queries: " << queries << ", paths found: " << found << (round > 0 ? " (after changes)" : "") << std::endl;
+
+            std::cerr << "Heap A*: " << search_time << " ms (" << search_time / queries << " ms/query)" << std::endl;
+
+            std::cerr << "Hierarchical: " << hierarchy_time << " ms (" << hierarchy_time / queries << " ms/query), " << (round > 0 ? "update: " : "build: ") << build_time << " ms" << std::endl;
+
+            std::cerr << "Speedup: " << (hierarchy_time > 0.0 ? search_time / hierarchy_time : 0.0) << "x, path cost: +" << (costs > 0.0 ? (abstract_costs / costs - 1.0) * 100.0 : 0.0) << "%, mismatches: " << mismatches << std::endl;
+
+            total_mismatches += mismatches;
+
+            // change the terrain of a few tiles and add units before the next round
+            for (auto i = 0; i < width * height / 10000 + 1; i++)
+            {
+                auto point = Point(random.NextInt(0, width - 1), random.NextInt(0, height - 1));
+
+                map.SetTerrain(point, map[point].Terrain == TerrainType::SEA ? TerrainType::SETTLED : TerrainType::SEA);
+
+                point = Point(random.NextInt(0, width - 1), random.NextInt(0, height - 1));
+
+                units.push_back(Unit::Base(Unit::Base(UnitType::GROUND, Kingdom::NONE, 1, 1, Asset::NONE, "Benchmark"), int(units.size())));
+
+                map.Put(units.back(), point);
+            }
+        }
+
+        return total_mismatches;
+    }
+
+    // compare search strategies on random queries (time, path cost and number of tiles expanded)
+    void Strategies(Map &map, int queries, Random::Base &random)
+    {
+        auto stack = Stack{{-1, UnitType::GROUND, Kingdom::NONE, Mercenary::NONE}, {-1, UnitType::GROUND, Kingdom::NONE, Mercenary::NONE}};
+
+        auto sources = Points();
+
+        auto destinations = Points();
+
+        for (auto i = 0; i < queries; i++)
+        {
+            sources.push_back(Point(random.NextInt(0, map.Dimensions.X - 1), random.NextInt(0, map.Dimensions.Y - 1)));
+
+            destinations.push_back(Point(random.NextInt(0, map.Dimensions.X - 1), random.NextInt(0, map.Dimensions.Y - 1)));
+        }
+
+        const auto strategies = List<Move::Strategy>{Move::Strategy::ASTAR, Move::Strategy::TIE_BREAKING, Move::Strategy::BIDIRECTIONAL};
+
+        const auto names = List<std::string>{"A*", "Tie breaking", "Bidirectional"};
+
+        auto workspace = Move::Workspace(map);
+
+        auto paths = List<Move::Path>(queries);
+
+        auto path = Move::Path();
+
+        for (auto strategy = 0; strategy < strategies.size(); strategy++)
+        {
+            auto expanded = 0LL;
+
+            auto mismatches = 0;
+
+            auto start = Benchmark::Clock::now();
+
+            for (auto i = 0; i < queries; i++)
+            {
+                auto &result = strategy == 0 ? paths[i] : path;
+
+                Move::FindPath(map, sources[i], destinations[i], stack, workspace, result, strategies[strategy]);
+
+                expanded += workspace.Expanded();
+
+                if (strategy > 0)
+                {
+                    if (path.Points.empty() != paths[i].Points.empty() || Benchmark::Cost(map, path) != Benchmark::Cost(map, paths[i]))
+                    {
+                        mismatches++;
+                    }
+                    else if (path.Points.empty() && map.Distance(path.Closest, destinations[i]) != map.Distance(paths[i].Closest, destinations[i]))
+                    {
+                        mismatches++;
+                    }
+                }
+            }
+
+            auto time = Benchmark::Elapsed(start);
+
+            std::cerr << names[strategy] << ": " << time << " ms (" << time / queries << " ms/query), expanded: " << double(expanded) / queries << " tiles/query, mismatches: " << mismatches << std::endl;
+        }
+    }
+
+    // compare search strategies on a random map and on open terrain
+    void Strategies(int width, int height, int queries, int seed)
+    {
+        auto random = Random::Base(seed);
+
+        auto map = Map(width, height, 54, true);
+
+        auto units = Units();
+
+        Benchmark::Generate(map, units, random);
+
+        std::cerr << "Map: " << width << "x" << height << ", queries: " << queries << std::endl;
+
+        Benchmark::Strategies(map, queries, random);
+
+        auto open = Map(width, height, 54, true);
+
+        for (auto index = 0; index < open.Area(); index++)
+        {
+            open.At(index).Terrain = TerrainType::SETTLED;
+
+            open.At(index).StackLimit = DarkEmperor::StackLimit(TerrainType::SETTLED);
+        }
+
+        open.Synchronize();
+
+        std::cerr << "Map: " << width << "x" << height << " (open terrain), queries: " << queries << std::endl;
+
+        Benchmark::Strategies(open, queries, random);
+    }
+
+    // repeated evaluation passes over the same queries with and without the path cache, with a few changes to the map between turns
+    void Cache(int width, int height, int queries, int seed)
+    {
+        auto random = Random::Base(seed);
+
+        auto map = Map(width, height, 54, true);
+
+        auto units = Units();
+
+        Benchmark::Generate(map, units, random);
+
+        auto stack = Stack{{-1, UnitType::GROUND, Kingdom::NONE, Mercenary::NONE}, {-1, UnitType::GROUND, Kingdom::NONE, Mercenary::NONE}};
+
+        auto sources = Points();
+
+        auto destinations = Points();
+
+        for (auto i = 0; i < queries; i++)
+        {
+            sources.push_back(Point(random.NextInt(0, width - 1), random.NextInt(0, height - 1)));
+
+            destinations.push_back(Point(random.NextInt(0, width - 1), random.NextInt(0, height - 1)));
+        }
+
+        const auto turns = 5;
+
+        const auto passes = 4;
+
+        auto workspace = Move::Workspace(map);
+
+        auto cache = Move::Cache();
+
+        auto paths = List<Move::Path>(queries);
+
+        auto cached = List<Move::Path>(queries);
+
+        auto search_time = 0.0;
+
+        auto cache_time = 0.0;
+
+        auto mismatches = 0;
+
+        for (auto turn = 0; turn < turns; turn++)
+        {
+            for (auto pass = 0; pass < passes; pass++)
+            {
+                auto start = Benchmark::Clock::now();
+
+                for (auto i = 0; i < queries; i++)
+                {
+                    Move::FindPath(map, sources[i], destinations[i], stack, workspace, paths[i]);
+                }
+
+                search_time += Benchmark::Elapsed(start);
+
+                start = Benchmark::Clock::now();
+
+                for (auto i = 0; i < queries; i++)
+                {
+                    cache.FindPath(map, sources[i], destinations[i], stack, cached[i]);
+                }
+
+                cache_time += Benchmark::Elapsed(start);
+
+                for (auto i = 0; i < queries; i++)
+                {
+                    if (!Benchmark::Same(paths[i], cached[i]))
+                    {
+                        mismatches++;
+                    }
+                }
+            }
+
+            // move a few units at the end of the turn
+            for (auto i = 0; i < 4; i++)
+            {
+                auto &unit = units[random.NextInt(0, int(units.size()) - 1)];
+
+                auto index = -1;
+
+                for (auto tile = 0; tile < map.Area() && index < 0; tile++)
+                {
+                    for (auto &search : map.At(tile).Units)
+                    {
+                        if (search.Id == unit.Id)
+                        {
+                            index = tile;
+
+                            break;
+                        }
+                    }
+                }
+
+                if (index >= 0)
+                {
+                    map.Remove(unit, map.Location(index));
+
+                    map.Put(unit, Point(random.NextInt(0, width - 1), random.NextInt(0, height - 1)));
+                }
+            }
+        }
+
+        std::cerr << "Map: " << width << "x" << height << ", queries: " << queries << ", turns: " << turns << ", passes per turn: " << passes << std::endl;
+
+        std::cerr << "Heap A*: " << search_time << " ms" << std::endl;
+
+        std::cerr << "Path cache: " << cache_time << " ms (hits: " << cache.Hits << ", misses: " << cache.Misses << ", stale: " << cache.Stale << ", hit rate: " << cache.HitRate() * 100.0 << "%)" << std::endl;
+
+        std::cerr << "Speedup: " << (cache_time > 0.0 ? search_time / cache_time : 0.0) << "x, mismatches: " << mismatches << std::endl;
+    }
+
+    // compare checking passability tile by tile with checking whole rows
+    void Passable(int width, int height, int iterations, int seed)
+    {
+        auto random = Random::Base(seed);
+
+        auto map = Map(width, height, 54, true);
+
+        auto units = Units();
+
+        Benchmark::Generate(map, units, random);
+
+        auto stack = Stack{{-1, UnitType::GROUND, Kingdom::NONE, Mercenary::NONE}, {-1, UnitType::LEADER, Kingdom::NONE, Mercenary::NONE}};
+
+        auto tiles = List<std::uint8_t>(map.Area());
+
+        auto start = Benchmark::Clock::now();
+
+        for (auto i = 0; i < iterations; i++)
+        {
+            for (auto y = 0; y < height; y++)
+            {
+                for (auto x = 0; x < width; x++)
+                {
+                    auto point = Point(x, y);
+
+                    tiles[map.Index(point)] = Move::IsPassable(map, point, stack) ? 1 : 0;
+                }
+            }
+        }
+
+        auto tile_time = Benchmark::Elapsed(start);
+
+        auto row = List<std::uint8_t>();
+
+        auto mismatches = 0;
+
+        start = Benchmark::Clock::now();
+
+        for (auto i = 0; i < iterations; i++)
+        {
+            for (auto y = 0; y < height; y++)
+            {
+                Move::Passable(map, y, stack, row);
+
+                if (i == 0)
+                {
+                    for (auto x = 0; x < width; x++)
+                    {
+                        mismatches += (row[x] != tiles[map.Index(x, y)] ? 1 : 0);
+                    }
+                }
+            }
+        }
+
+        auto row_time = Benchmark::Elapsed(start);
+
+        std::cerr << "Map: " << width << "x" << height << ", iterations: " << iterations << std::endl;
+
+        std::cerr << "Tile by tile: " << tile_time << " ms (" << tile_time / iterations << " ms/map)" << std::endl;
+
+        std::cerr << "Rows: " << row_time << " ms (" << row_time / iterations << " ms/map)" << std::endl;
+
+        std::cerr << "Speedup: " << (row_time > 0.0 ? tile_time / row_time : 0.0) << "x, mismatches: " << mismatches << std::endl;
+    }
+
+    // compare per-kingdom revenue loop with the single-pass ledger
+    void Revenue(int width, int height, int iterations, int seed)
+    {
+        auto random = Random::Base(seed);
+
+        auto map = Map(width, height, 54, true);
+
+        auto units = Units();
+
+        Benchmark::Generate(map, units, random);
+
+        auto kingdoms = int(Kingdom::ZOLAHAURESLOR) + 1;
+
+        auto totals = List<int>(kingdoms, 0);
+
+        auto start = Benchmark::Clock::now();
+
+        for (auto i = 0; i < iterations; i++)
+        {
+            for (auto kingdom = 0; kingdom < kingdoms; kingdom++)
+            {
+                totals[kingdom] = Game::Revenue(map, Kingdom(kingdom));
+            }
+        }
+
+        auto loop_time = Benchmark::Elapsed(start);
+
+        auto ledger = Game::Ledger();
+
+        start = Benchmark::Clock::now();
+
+        for (auto i = 0; i < iterations; i++)
+        {
+            ledger = Game::Revenue(map);
+        }
+
+        auto batch_time = Benchmark::Elapsed(start);
+
+        auto mismatches = 0;
+
+        for (auto kingdom = 0; kingdom < kingdoms; kingdom++)
+        {
+            mismatches += (totals[kingdom] != ledger.Revenue(Kingdom(kingdom)) ? 1 : 0);
+        }
+
+        std::cerr << "Map: " << width << "x" << height << ", iterations: " << iterations << std::endl;
+
+        std::cerr << "Per-kingdom loop: " << loop_time << " ms (" << loop_time / iterations << " ms/turn)" << std::endl;
+
+        std::cerr << "Single pass: " << batch_time << " ms (" << batch_time / iterations << " ms/turn)" << std::endl;
+
+        std::cerr << "Speedup: " << (batch_time > 0.0 ? loop_time / batch_time : 0.0) << "x, mismatches: " << mismatches << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "To Use:" << std::endl
+                  << std::endl
+                  << argv[0] << " path [width] [height] [queries] [seed]" << std::endl
+                  << argv[0] << " hierarchy [width] [height] [queries] [seed] [seeds]" << std::endl
+                  << argv[0] << " strategy [width] [height] [queries] [seed]" << std::endl
+                  << argv[0] << " cache [width] [height] [queries] [seed]" << std::endl
+                  << argv[0] << " passable [width] [height] [iterations] [seed]" << std::endl
+                  << argv[0] << " revenue [width] [height] [iterations] [seed]" << std::endl;
+
+        exit(1);
+    }
+
+    auto mode = DarkEmperor::Utilities::ToUpper(argv[1]);
+
+    auto width = argc > 2 ? std::atoi(argv[2]) : 40;
+
+    auto height = argc > 3 ? std::atoi(argv[3]) : 27;
+
+    auto queries = argc > 4 ? std::atoi(argv[4]) : 1000;
+
+    auto seed = argc > 5 ? std::atoi(argv[5]) : 1985;
+
+    auto result = 0;
+
+    if (mode == "PATH")
+    {
+        DarkEmperor::Benchmark::Paths(width, height, queries, seed);
+    }
+    else if (mode == "HIERARCHY")
+    {
+        // several maps (seeds), as missing paths depend on the layout of the map
+        auto seeds = argc > 6 ? std::max(1, std::atoi(argv[6])) : 5;
+
+        auto mismatches = 0;
+
+        for (auto i = 0; i < seeds; i++)
+        {
+            mismatches += DarkEmperor::Benchmark::Hierarchy(argc > 2 ? width : 256, argc > 3 ? height : 256, argc > 4 ? queries : 200, seed + i);
+        }
+
+        if (mismatches > 0)
+        {
+            std::cerr << "FAILED: hierarchical path finding disagrees with A* on " << mismatches << " queries" << std::endl;
+
+            result = 1;
+        }
+    }
+    else if (mode == "STRATEGY")
+    {
+        DarkEmperor::Benchmark::Strategies(width, height, queries, seed);
+    }
+    else if (mode == "CACHE")
+    {
+        DarkEmperor::Benchmark::Cache(width, height, argc > 4 ? queries : 200, seed);
+    }
+    else if (mode == "PASSABLE")
+    {
+        DarkEmperor::Benchmark::Passable(width, height, queries, seed);
+    }
+    else if (mode == "REVENUE")
+    {
+        if (argc > 3)
+        {
+            DarkEmperor::Benchmark::Revenue(width, height, queries, seed);
+        }
+        else
+        {
+            // Loslon and synthetic large maps
+            DarkEmperor::Benchmark::Revenue(40, 27, queries, seed);
+
+            DarkEmperor::Benchmark::Revenue(256, 256, std::max(1, queries / 50), seed);
+
+            DarkEmperor::Benchmark::Revenue(1024, 1024, std::max(1, queries / 1000), seed);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,66 @@
+#ifndef __COLOR_TYPES_HPP__
+#define __COLOR_TYPES_HPP__
+
+#include <cstdint>
+
+// color values and channel functions (without SDL, see Color.hpp)
+namespace DarkEmperor
+{
+    // same as the SDL types
+    typedef std::uint8_t Uint8;
+
+    typedef std::uint32_t Uint32;
+}
+
+namespace DarkEmperor::Color
+{
+    Uint8 R(Uint32 c) { return (Uint8)((c & 0xFF0000) >> 16); }
+
+    Uint8 G(Uint32 c) { return (Uint8)((c & 0x00FF00) >> 8); }
+
+    Uint8 B(Uint32 c) { return (Uint8)(c & 0x0000FF); }
+
+    Uint8 A(Uint32 c) { return (Uint8)(c >> 24); }
+
+    Uint32 O(Uint32 c, Uint8 a) { return ((c & ((Uint32)0x00FFFFFF)) | ((Uint32)(a << 24))); }
+
+    Uint32 Active = 0xFFFFFFFF;
+
+    Uint32 Inactive = 0xFF606060;
+
+    Uint32 Highlight = 0xFFFF0000;
+
+    Uint32 Background = 0xFF000000;
+
+    Uint32 Transparent = 0x00000000;
+
+    Uint32 Blur = 0x7F000000;
+
+    // color definitions
+    Uint32 White = 0xFFFFFFFF;
+
+    Uint32 Grey = 0xFF606060;
+
+    Uint32 Black = 0xFF000000;
+
+    Uint32 Blue = 0xFF00FFFF;
+
+    Uint32 Red = 0xFFFF0000;
+
+    Uint32 Yellow = 0xFFFFFF00;
+
+    Uint32 Green = 0xFF008000;
+
+    Uint32 Purple = 0xFF800080;
+
+    Uint32 Orange = 0xFFCD8500;
+
+    Uint32 Brown = 0xFFA68064;
+
+    Uint32 U(Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+    {
+        return (Uint32)(a << 24 | r << 16 | g << 8 | b);
+    }
+}
+
+#endif
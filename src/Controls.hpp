@@ -103,6 +103,9 @@ namespace DarkEmperor::Controls
         // quit/exit/terminate event
         bool Quit = false;
 
+        // the renderer has lost the contents of its render-target textures (these need to be redrawn)
+        bool Reset = false;
+
         // blink curser
         bool Blink = false;
 
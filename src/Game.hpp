@@ -8,66 +8,91 @@
 
 namespace DarkEmperor::Game
 {
-    // check if other units are exerting control over this tile
+    // check if other units are exerting control over this tile (or its neighbors)
+    //
+    // zone of control is maintained by Map::Put / Map::Remove, so this is a lookup
+    bool IsControlled(Map &map, int index, Kingdom kingdom)
+    {
+        return map.Rules.IsControlled(index, kingdom);
+    }
+
+    // check if other units are exerting control over this tile (or its neighbors)
     bool IsControlled(Map &map, Point point, Kingdom kingdom)
     {
-        auto controlled = true;
+        return map.IsValid(point) ? Game::IsControlled(map, map.Index(point), kingdom) : true;
+    }
 
-        if (map.IsValid(point))
+    int Revenue(Map &map, Kingdom kingdom)
+    {
+        auto production = 0;
+
+        auto lost = 0;
+
+        auto &rules = map.Rules;
+
+        // sweep the dense rules view
+        for (auto index = 0; index < map.Area(); index++)
         {
-            if (map[point].Others(kingdom) > 0)
-            {
-                controlled = false;
-            }
-            else
+            if (rules.Owner[index] == kingdom)
             {
-                for (auto neighbor : map.Neighbors(point))
+                if (!Game::IsControlled(map, index, kingdom))
                 {
-                    auto &tile = map[point];
-
-                    if (tile.Others(kingdom) > 0)
-                    {
-                        controlled = false;
-
-                        break;
-                    }
+                    // TODO: Tax according to terrain type
+                    lost++;
+                }
+                else if (rules.IsCity(index) && rules.Count(index, kingdom) > 0)
+                {
+                    production += rules.CityValue[index];
                 }
             }
         }
 
-        return controlled;
+        return std::max(0, production - lost);
     }
 
-    int Revenue(Map &map, Kingdom kingdom)
+    // production and losses of every kingdom (indexed by kingdom)
+    class Ledger
     {
-        auto production = 0;
+    public:
+        std::array<int, TotalKingdoms> Production = {};
 
-        auto lost = 0;
+        std::array<int, TotalKingdoms> Lost = {};
+
+        Ledger() {}
 
-        for (auto y = 0; y < map.Dimensions.Y; y++)
+        // net revenue of kingdom (same as Game::Revenue(map, kingdom))
+        int Revenue(Kingdom kingdom)
         {
-            for (auto x = 0; x < map.Dimensions.X; x++)
-            {
-                auto point = Point(x, y);
+            return kingdom != Kingdom::NONE ? std::max(0, this->Production[int(kingdom)] - this->Lost[int(kingdom)]) : 0;
+        }
+    };
 
-                auto &tile = map[point];
+    // compute production and losses of all kingdoms in a single pass over the map
+    Game::Ledger Revenue(Map &map)
+    {
+        auto ledger = Game::Ledger();
+
+        auto &rules = map.Rules;
+
+        for (auto index = 0; index < map.Area(); index++)
+        {
+            auto owner = rules.Owner[index];
 
-                if (tile.Owner == kingdom)
+            if (owner != Kingdom::NONE)
+            {
+                if (!Game::IsControlled(map, index, owner))
+                {
+                    // TODO: Tax according to terrain type
+                    ledger.Lost[int(owner)]++;
+                }
+                else if (rules.IsCity(index) && rules.Count(index, owner) > 0)
                 {
-                    if (!Game::IsControlled(map, point, kingdom))
-                    {
-                        // TODO: Tax according to terrain type
-                        lost++;
-                    }
-                    else if (tile.IsCity() && tile.Count(kingdom) > 0)
-                    {
-                        production += tile.CityValue;
-                    }
+                    ledger.Production[int(owner)] += rules.CityValue[index];
                 }
             }
         }
 
-        return std::max(0, production - lost);
+        return ledger;
     }
 
     class Session
@@ -76,8 +101,8 @@ namespace DarkEmperor::Game
         // list of game features
         List<Feature> Features = {};
 
-        // units
-        Units Units = {};
+        // units (one array per field), which also allocates and recycles unit ids
+        Unit::Registry Registry = Unit::Registry();
 
         // the world of Loslon
         Map Loslon = Map();
@@ -93,13 +118,45 @@ namespace DarkEmperor::Game
             // TODO: load tile settings
         }
 
-        // add a unit
-        void Add(Unit::Base unit)
+        // add a unit (ids of removed units are reused)
+        Unit::Handle Add(Unit::Base unit)
+        {
+            return this->Registry.Add(unit);
+        }
+
+        // place a unit on the map (stale handles are ignored)
+        void Put(Unit::Handle handle, Point point)
+        {
+            if (this->Registry.IsValid(handle))
+            {
+                this->Loslon.Put(this->Registry.Identify(handle.Id), point);
+            }
+        }
+
+        // move a unit to another tile on the map (stale handles are ignored)
+        void Move(Unit::Handle handle, Point point)
         {
-            // add unit to list
-            auto id = int(this->Units.size());
+            if (this->Registry.IsValid(handle))
+            {
+                this->Loslon.Move(this->Registry.Identify(handle.Id), point);
+            }
+        }
 
-            this->Units.push_back(Unit::Base(unit, id));
+        // tile index of the unit (the map keeps track of unit locations), -1 if it is not on the map or the handle is stale
+        int Locate(Unit::Handle handle)
+        {
+            return this->Registry.IsValid(handle) ? this->Loslon.Locate(handle.Id) : -1;
+        }
+
+        // remove a unit (it leaves the map and its id is released for reuse, stale handles are ignored)
+        void Remove(Unit::Handle handle)
+        {
+            if (this->Registry.IsValid(handle))
+            {
+                this->Loslon.Remove(handle.Id);
+
+                this->Registry.Remove(handle.Id);
+            }
         }
     };
 }
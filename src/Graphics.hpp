@@ -1,6 +1,7 @@
 #ifndef __GRAPHICS_HPP__
 #define __GRAPHICS_HPP__
 
+#include <cmath>
 #include <iostream>
 #include <vector>
 
@@ -440,12 +441,6 @@ namespace DarkEmperor::Graphics
         Graphics::RenderHex(graphics, nullptr, hex, offset, color, flat);
     }
 
-    // render texture within hex boundaries
-    void RenderHex(Base &graphics, SDL_Texture *texture, Points hex, Point offset, bool flat)
-    {
-        Graphics::RenderHex(graphics, texture, hex, offset, 0, flat);
-    }
-
     // mid-point function for filled circle
     void MidPointFilled(Base &graphics, Point center, int x, int y, Uint32 color)
     {
@@ -590,16 +585,294 @@ namespace DarkEmperor::Graphics
         }
     }
 
-    void RenderCircle(Base &graphics, SDL_Texture *texture, Point center, int radius, Uint32 color)
+    // part of a texture cut into a hex or a circle
+    class Cut
+    {
+    public:
+        SDL_Texture *Texture = nullptr;
+
+        Shape Shape = Shape::NONE;
+
+        // top-left corner of the area cut out of the texture
+        Point Location = Point(0, 0);
+
+        Point Dimensions = Point(0, 0);
+
+        bool Flat = false;
+
+        Cut(SDL_Texture *texture, DarkEmperor::Shape shape, Point location, Point dimensions, bool flat) : Texture(texture), Shape(shape), Location(location), Dimensions(dimensions), Flat(flat) {}
+
+        Cut() {}
+
+        bool operator==(const Cut &cut) const
+        {
+            return this->Texture == cut.Texture && this->Shape == cut.Shape && this->Location.X == cut.Location.X && this->Location.Y == cut.Location.Y && this->Dimensions.X == cut.Dimensions.X && this->Dimensions.Y == cut.Dimensions.Y && this->Flat == cut.Flat;
+        }
+
+        class Hash
+        {
+        public:
+            std::size_t operator()(const Cut &cut) const
+            {
+                auto hash = std::uint64_t(reinterpret_cast<std::uintptr_t>(cut.Texture)) * 0x9E3779B97F4A7C15ULL;
+
+                hash ^= (std::uint64_t(std::uint16_t(cut.Location.X)) << 48 | std::uint64_t(std::uint16_t(cut.Location.Y)) << 32 | std::uint64_t(std::uint16_t(cut.Dimensions.X)) << 16 | std::uint64_t(std::uint16_t(cut.Dimensions.Y))) + (hash << 6) + (hash >> 2);
+
+                return std::size_t(hash ^ (std::uint64_t(cut.Shape) << 1 | (cut.Flat ? 1 : 0)));
+            }
+        };
+    };
+
+    // location of a cut in the atlas
+    class Sprite
+    {
+    public:
+        // atlas texture, nullptr if the cut did not fit in the atlas
+        SDL_Texture *Texture = nullptr;
+
+        // area of the atlas holding the cut
+        Point Location = Point(0, 0);
+
+        Point Dimensions = Point(0, 0);
+
+        // position of the top-left corner relative to the point it is drawn at
+        Point Offset = Point(0, 0);
+
+        Sprite() {}
+    };
+
+    // hexes and circles cut out of textures once and packed row by row (on shelves) into a single render-target texture, so that drawing one is a single copy instead of one copy per line
+    class Atlas
+    {
+    public:
+        SDL_Texture *Texture = nullptr;
+
+        Point Dimensions = Point(2048, 2048);
+
+        // free space in the atlas
+        Asset::Shelf Shelf = Asset::Shelf(Point(2048, 2048));
+
+        UnorderedMap<Graphics::Cut, Graphics::Sprite, Graphics::Cut::Hash> Sprites = {};
+
+        // value of Asset::Generation when the sprites were cut (textures may have been freed and their addresses reused since)
+        unsigned int Generation = 0;
+
+        Atlas(Point dimensions) : Dimensions(dimensions), Shelf(dimensions) {}
+
+        Atlas() {}
+
+        // forget all sprites
+        void Clear()
+        {
+            this->Sprites.clear();
+
+            this->Shelf = Asset::Shelf(this->Dimensions);
+
+            this->Generation = Asset::Generation;
+        }
+
+        // forget all sprites and clear the atlas texture to transparent, so that new sprites do not show pixels of old ones around their shape
+        void Reset(Base &graphics)
+        {
+            if (this->Texture)
+            {
+                auto target = SDL_GetRenderTarget(graphics.Renderer);
+
+                SDL_SetRenderTarget(graphics.Renderer, this->Texture);
+
+                SDL_SetRenderDrawColor(graphics.Renderer, 0, 0, 0, 0);
+
+                SDL_RenderClear(graphics.Renderer);
+
+                SDL_SetRenderTarget(graphics.Renderer, target);
+            }
+
+            this->Clear();
+        }
+
+        // release the atlas texture
+        void Destroy()
+        {
+            Asset::Free(&this->Texture);
+
+            this->Clear();
+        }
+
+        // create the atlas texture if needed. returns false if render-target textures are not available
+        bool Prepare(Base &graphics)
+        {
+            if (this->Generation != Asset::Generation)
+            {
+                this->Reset(graphics);
+            }
+
+            if (!this->Texture && graphics.Renderer && SDL_RenderTargetSupported(graphics.Renderer))
+            {
+                this->Texture = SDL_CreateTexture(graphics.Renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, this->Dimensions.X, this->Dimensions.Y);
+
+                if (this->Texture)
+                {
+                    SDL_SetTextureBlendMode(this->Texture, SDL_BLENDMODE_BLEND);
+                }
+
+                this->Reset(graphics);
+            }
+
+            return this->Texture != nullptr;
+        }
+
+        // find the sprite of the cut or make one by drawing the cut into the atlas (with draw). the sprite has no texture if it could not be made
+        template <typename F>
+        Graphics::Sprite Find(Base &graphics, Graphics::Cut &cut, Point offset, F draw)
+        {
+            auto sprite = Graphics::Sprite();
+
+            if (this->Prepare(graphics))
+            {
+                auto found = this->Sprites.find(cut);
+
+                if (found != this->Sprites.end())
+                {
+                    sprite = found->second;
+                }
+                else
+                {
+                    auto packed = this->Shelf.Pack(cut.Dimensions, sprite.Location);
+
+                    auto fits = cut.Dimensions.X <= this->Dimensions.X && cut.Dimensions.Y <= this->Dimensions.Y;
+
+                    // start over when the atlas is full (sprites still in use are cut again when next drawn)
+                    if (!packed && fits)
+                    {
+                        this->Reset(graphics);
+
+                        packed = this->Shelf.Pack(cut.Dimensions, sprite.Location);
+                    }
+
+                    if (packed)
+                    {
+                        sprite.Texture = this->Texture;
+
+                        sprite.Dimensions = cut.Dimensions;
+
+                        sprite.Offset = offset;
+
+                        auto target = SDL_GetRenderTarget(graphics.Renderer);
+
+                        auto blend = SDL_BLENDMODE_BLEND;
+
+                        SDL_GetTextureBlendMode(cut.Texture, &blend);
+
+                        SDL_SetRenderTarget(graphics.Renderer, this->Texture);
+
+                        // copy the texture as is (including alpha) instead of blending it with the transparent atlas
+                        SDL_SetTextureBlendMode(cut.Texture, SDL_BLENDMODE_NONE);
+
+                        draw(sprite.Location);
+
+                        SDL_SetTextureBlendMode(cut.Texture, blend);
+
+                        SDL_SetRenderTarget(graphics.Renderer, target);
+                    }
+
+                    // also remember cuts that are larger than the atlas, so that they are not tried again
+                    this->Sprites[cut] = sprite;
+                }
+            }
+
+            return sprite;
+        }
+
+        // sprite of the texture inside the hex (hex coordinates are also used as texture coordinates)
+        Graphics::Sprite Hex(Base &graphics, SDL_Texture *texture, Points &hex, bool flat)
+        {
+            auto first = hex[0];
+
+            auto last = hex[0];
+
+            for (auto &point : hex)
+            {
+                first = Point(std::min(first.X, point.X), std::min(first.Y, point.Y));
+
+                last = Point(std::max(last.X, point.X), std::max(last.Y, point.Y));
+            }
+
+            auto cut = Graphics::Cut(texture, Shape::HEX, first, last - first + 1, flat);
+
+            return this->Find(graphics, cut, first, [&](Point location)
+                              { Graphics::RenderHex(graphics, texture, hex, location - first, 0, flat); });
+        }
+
+        // sprite of the texture inside a circle around (center)
+        Graphics::Sprite Circle(Base &graphics, SDL_Texture *texture, Point center, int radius)
+        {
+            auto cut = Graphics::Cut(texture, Shape::CIRCLE, center - radius, Point(radius * 2, radius * 2), false);
+
+            return this->Find(graphics, cut, Point(-radius, -radius), [&](Point location)
+                              { Graphics::RenderCircle(graphics, texture, center, location + radius - center, radius); });
+        }
+    };
+
+    // cut textures used by RenderHex / RenderCircle
+    Graphics::Atlas Sprites = Graphics::Atlas();
+
+    // pre-cut hex and circle textures toggle (when disabled, textures are clipped line by line every time they are drawn)
+    bool SpritesEnabled = true;
+
+    // draw sprite at location. returns false if there is no sprite
+    bool RenderSprite(Base &graphics, Graphics::Sprite &sprite, Point location)
+    {
+        if (sprite.Texture)
+        {
+            SDL_Rect src, dst;
+
+            Graphics::Dimensions(src, sprite.Dimensions.X, sprite.Dimensions.Y);
+
+            Graphics::Assign(src, sprite.Location);
+
+            Graphics::Dimensions(dst, src);
+
+            Graphics::Assign(dst, location + sprite.Offset);
+
+            SDL_RenderCopy(graphics.Renderer, sprite.Texture, &src, &dst);
+        }
+
+        return sprite.Texture != nullptr;
+    }
+
+    // render texture within hex boundaries
+    void RenderHex(Base &graphics, SDL_Texture *texture, Points hex, Point offset, bool flat)
+    {
+        auto sprite = Graphics::Sprite();
+
+        if (texture && hex.size() > 0 && Graphics::SpritesEnabled)
+        {
+            sprite = Graphics::Sprites.Hex(graphics, texture, hex, flat);
+        }
+
+        if (!Graphics::RenderSprite(graphics, sprite, offset))
+        {
+            Graphics::RenderHex(graphics, texture, hex, offset, 0, flat);
+        }
+    }
+
+    // render the image at (source) with (dimensions) in the texture inside a circle
+    void RenderCircle(Base &graphics, SDL_Texture *texture, Point source, Point dimensions, Point center, int radius, Uint32 color)
     {
-        // copy from center of the texture
-        auto width = Asset::Width(texture) / 2;
+        // copy from center of the image
+        auto offset = source + dimensions / 2;
 
-        auto height = Asset::Height(texture) / 2;
+        auto sprite = Graphics::Sprite();
 
-        auto offset = Point(width, height);
+        if (texture && radius > 0 && Graphics::SpritesEnabled)
+        {
+            sprite = Graphics::Sprites.Circle(graphics, texture, offset, radius);
+        }
 
-        Graphics::RenderCircle(graphics, texture, offset, center - offset, radius);
+        if (!Graphics::RenderSprite(graphics, sprite, center))
+        {
+            Graphics::RenderCircle(graphics, texture, offset, center - offset, radius);
+        }
 
         if (color != 0)
         {
@@ -607,8 +880,13 @@ namespace DarkEmperor::Graphics
         }
     }
 
-    // base render texture function
-    void RenderTexture(Base &graphics, SDL_Texture *texture, int texture_w, int texture_h, int x, int y, int w, int h, int bounds, int offset, Uint32 border, Uint32 background)
+    void RenderCircle(Base &graphics, SDL_Texture *texture, Point center, int radius, Uint32 color)
+    {
+        Graphics::RenderCircle(graphics, texture, Point(0, 0), Point(Asset::Width(texture), Asset::Height(texture)), center, radius, color);
+    }
+
+    // base render texture function (source is the location of the image in the texture)
+    void RenderTexture(Base &graphics, SDL_Texture *texture, Point source, int texture_w, int texture_h, int x, int y, int w, int h, int bounds, int offset, Uint32 border, Uint32 background)
     {
         if (graphics.Renderer)
         {
@@ -616,7 +894,7 @@ namespace DarkEmperor::Graphics
 
             Graphics::Dimensions(src, texture_w, std::min(texture_h, bounds));
 
-            Graphics::Assign(src, 0, offset);
+            Graphics::Assign(src, source.X, source.Y + offset);
 
             Graphics::Dimensions(dst, w, h);
 
@@ -643,6 +921,11 @@ namespace DarkEmperor::Graphics
         }
     }
 
+    void RenderTexture(Base &graphics, SDL_Texture *texture, int texture_w, int texture_h, int x, int y, int w, int h, int bounds, int offset, Uint32 border, Uint32 background)
+    {
+        Graphics::RenderTexture(graphics, texture, Point(0, 0), texture_w, texture_h, x, y, w, h, bounds, offset, border, background);
+    }
+
     // render texture at location
     void RenderTexture(Base &graphics, SDL_Texture *texture, int w, int h, int x, int y, Uint32 border, Uint32 background)
     {
@@ -691,6 +974,8 @@ namespace DarkEmperor::Graphics
     // close graphics system
     void Quit(Base &graphics)
     {
+        Graphics::Sprites.Destroy();
+
         if (graphics.Renderer != nullptr)
         {
             SDL_DestroyRenderer(graphics.Renderer);
@@ -725,8 +1010,21 @@ namespace DarkEmperor::Graphics
         SDL_Quit();
     }
 
+    // dimensions of the image of the element within its texture (the whole texture if the element has no dimensions)
+    Point ImageSize(Element &element)
+    {
+        auto dimensions = element.Dimensions;
+
+        if (dimensions.X <= 0 || dimensions.Y <= 0)
+        {
+            dimensions = Point(Asset::Width(element.Texture), Asset::Height(element.Texture));
+        }
+
+        return dimensions;
+    }
+
     // render scene element
-    void Render(Graphics::Base &graphics, Element element)
+    void Render(Graphics::Base &graphics, Element &element)
     {
         switch (element.Shape)
         {
@@ -737,7 +1035,8 @@ namespace DarkEmperor::Graphics
                 // render texture within hex boundaries
                 if (element.Texture != nullptr)
                 {
-                    Graphics::RenderHex(graphics, element.Texture, element.Hex, element.LocationOffset, element.Flat);
+                    // the hex is cut from the image at its location within the texture
+                    Graphics::RenderHex(graphics, element.Texture, DarkEmperor::Add(element.Hex, element.Source), element.LocationOffset - element.Source, element.Flat);
                 }
                 else
                 {
@@ -765,7 +1064,7 @@ namespace DarkEmperor::Graphics
 
             if (element.Texture != nullptr)
             {
-                Graphics::RenderTexture(graphics, element.Texture, element.Dimensions.X, element.Dimensions.Y, element.Location.X, element.Location.Y, element.Dimensions.X, element.Dimensions.Y, element.TextureBounds, element.TextureOffset, element.Border, element.Background);
+                Graphics::RenderTexture(graphics, element.Texture, element.Source, element.Dimensions.X, element.Dimensions.Y, element.Location.X, element.Location.Y, element.Dimensions.X, element.Dimensions.Y, element.TextureBounds, element.TextureOffset, element.Border, element.Background);
             }
             else
             {
@@ -793,7 +1092,7 @@ namespace DarkEmperor::Graphics
             if (element.Texture != nullptr && element.Radius > 0)
             {
                 // draw texture within circle
-                Graphics::RenderCircle(graphics, element.Texture, element.Location, element.Radius, 0);
+                Graphics::RenderCircle(graphics, element.Texture, element.Source, Graphics::ImageSize(element), element.Location, element.Radius, 0);
             }
             else if (element.Radius > 0)
             {
@@ -807,33 +1106,847 @@ namespace DarkEmperor::Graphics
 
             if (element.Texture != nullptr)
             {
-                Graphics::RenderTexture(graphics, element.Texture, element.Dimensions.X, element.Dimensions.Y, element.Location.X, element.Location.Y, element.Dimensions.X, element.Dimensions.Y, element.TextureBounds, element.TextureOffset, element.Border, element.Background);
+                Graphics::RenderTexture(graphics, element.Texture, element.Source, element.Dimensions.X, element.Dimensions.Y, element.Location.X, element.Location.Y, element.Dimensions.X, element.Dimensions.Y, element.TextureBounds, element.TextureOffset, element.Border, element.Background);
             }
 
             break;
         }
     }
 
-    // render overlay on screen
-    void Overlay(Base &graphics, Scene &scene)
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    // number of segments used to approximate circles
+    const int CircleSegments = 32;
+
+    // check if texture is an asset page that can be drawn by a batch as is (no color modulation)
+    bool IsShared(SDL_Texture *texture)
     {
-        if (graphics.Renderer)
+        auto r = Uint8(0);
+
+        auto g = Uint8(0);
+
+        auto b = Uint8(0);
+
+        return Asset::IsPage(texture) && SDL_GetTextureColorMod(texture, &r, &g, &b) == 0 && r == 255 && g == 255 && b == 255;
+    }
+
+    // triangles collected from many shapes and submitted with a single SDL_RenderGeometry call.
+    // solid shapes sample the white area of the asset pages, so images from the same page can be drawn in the same batch
+    class Batch
+    {
+    public:
+        List<SDL_Vertex> Vertices = {};
+
+        List<int> Indices = {};
+
+        // unit circle
+        List<SDL_FPoint> Circle = {};
+
+        // asset page of the images in the batch (nullptr if solid shapes only)
+        SDL_Texture *Texture = nullptr;
+
+        // number of SDL_RenderGeometry calls made
+        int Calls = 0;
+
+        Batch()
         {
-            if (!scene.Clip.IsNone())
+            for (auto segment = 0; segment < Graphics::CircleSegments; segment++)
             {
-                // render only in visible areas
-                Graphics::Clip(graphics, scene.Clip, scene.ClipDimensions);
+                auto angle = 2.0 * std::acos(-1.0) * segment / Graphics::CircleSegments;
+
+                this->Circle.push_back(SDL_FPoint{float(std::cos(angle)), float(std::sin(angle))});
             }
-            else
+        }
+
+        // add vertex at position with texture coordinates
+        int Vertex(SDL_FPoint position, SDL_Color color, SDL_FPoint texel)
+        {
+            auto vertex = SDL_Vertex();
+
+            vertex.position = position;
+
+            vertex.color = color;
+
+            vertex.tex_coord = texel;
+
+            this->Vertices.push_back(vertex);
+
+            return int(this->Vertices.size()) - 1;
+        }
+
+        // add solid vertex (at the center of the pixel)
+        int Vertex(float x, float y, SDL_Color &color)
+        {
+            // center of the white area of the page
+            auto white = float(Asset::Blank) / 2.0f / float(Asset::PageSize);
+
+            return this->Vertex(SDL_FPoint{x + 0.5f, y + 0.5f}, color, SDL_FPoint{white, white});
+        }
+
+        void Triangle(int a, int b, int c)
+        {
+            this->Indices.push_back(a);
+
+            this->Indices.push_back(b);
+
+            this->Indices.push_back(c);
+        }
+
+        void Quad(int a, int b, int c, int d)
+        {
+            this->Triangle(a, b, c);
+
+            this->Triangle(a, c, d);
+        }
+
+        // filled convex polygon
+        void Polygon(Points &polygon, Point offset, Uint32 color)
+        {
+            auto sdl_color = Color::S(color);
+
+            auto first = int(this->Vertices.size());
+
+            for (auto &point : polygon)
             {
-                // reset clipping
-                Graphics::Clip(graphics);
+                this->Vertex(float(point.X + offset.X), float(point.Y + offset.Y), sdl_color);
             }
 
-            for (auto &element : scene.Elements)
+            for (auto vertex = 1; vertex < int(polygon.size()) - 1; vertex++)
             {
-                Graphics::Render(graphics, element);
+                this->Triangle(first, first + vertex, first + vertex + 1);
+            }
+        }
+
+        // one pixel wide line
+        void Line(Point start, Point end, Uint32 color)
+        {
+            auto sdl_color = Color::S(color);
+
+            auto dx = float(end.X - start.X);
+
+            auto dy = float(end.Y - start.Y);
+
+            auto length = std::sqrt(dx * dx + dy * dy);
+
+            // half-pixel normal (a zero length line becomes a single pixel)
+            auto nx = length > 0.0f ? -dy / length * 0.5f : 0.5f;
+
+            auto ny = length > 0.0f ? dx / length * 0.5f : 0.5f;
+
+            auto a = this->Vertex(start.X + nx, start.Y + ny, sdl_color);
+
+            auto b = this->Vertex(end.X + nx, end.Y + ny, sdl_color);
+
+            auto c = this->Vertex(end.X - nx, end.Y - ny, sdl_color);
+
+            auto d = this->Vertex(start.X - nx, start.Y - ny, sdl_color);
+
+            this->Quad(a, b, c, d);
+        }
+
+        // polygon outline
+        void Outline(Points &polygon, Point offset, Uint32 color)
+        {
+            for (auto vertex = 0; vertex < polygon.size(); vertex++)
+            {
+                this->Line(polygon[vertex] + offset, polygon[(vertex + 1) % polygon.size()] + offset, color);
+            }
+        }
+
+        // filled rectangle
+        void Rect(int w, int h, int x, int y, Uint32 color)
+        {
+            auto sdl_color = Color::S(color);
+
+            // rectangles cover whole pixels, so their corners are not moved to the pixel centers
+            auto a = this->Vertex(float(x) - 0.5f, float(y) - 0.5f, sdl_color);
+
+            auto b = this->Vertex(float(x + w) - 0.5f, float(y) - 0.5f, sdl_color);
+
+            auto c = this->Vertex(float(x + w) - 0.5f, float(y + h) - 0.5f, sdl_color);
+
+            auto d = this->Vertex(float(x) - 0.5f, float(y + h) - 0.5f, sdl_color);
+
+            this->Quad(a, b, c, d);
+        }
+
+        // rectangle outline (one pixel wide)
+        void Frame(int w, int h, int x, int y, Uint32 color)
+        {
+            this->Rect(w, 1, x, y, color);
+
+            this->Rect(w, 1, x, y + h - 1, color);
+
+            this->Rect(1, h - 2, x, y + 1, color);
+
+            this->Rect(1, h - 2, x + w - 1, y + 1, color);
+        }
+
+        // filled circle
+        void Disc(Point center, float radius, Uint32 color)
+        {
+            auto sdl_color = Color::S(color);
+
+            auto first = this->Vertex(float(center.X), float(center.Y), sdl_color);
+
+            for (auto &point : this->Circle)
+            {
+                this->Vertex(center.X + point.x * radius, center.Y + point.y * radius, sdl_color);
             }
+
+            for (auto segment = 0; segment < Graphics::CircleSegments; segment++)
+            {
+                this->Triangle(first, first + 1 + segment, first + 1 + (segment + 1) % Graphics::CircleSegments);
+            }
+        }
+
+        // circle outline (one pixel wide)
+        void Ring(Point center, float radius, Uint32 color)
+        {
+            auto sdl_color = Color::S(color);
+
+            auto first = int(this->Vertices.size());
+
+            for (auto &point : this->Circle)
+            {
+                this->Vertex(center.X + point.x * (radius - 0.5f), center.Y + point.y * (radius - 0.5f), sdl_color);
+
+                this->Vertex(center.X + point.x * (radius + 0.5f), center.Y + point.y * (radius + 0.5f), sdl_color);
+            }
+
+            for (auto segment = 0; segment < Graphics::CircleSegments; segment++)
+            {
+                auto next = (segment + 1) % Graphics::CircleSegments;
+
+                this->Quad(first + segment * 2, first + segment * 2 + 1, first + next * 2 + 1, first + next * 2);
+            }
+        }
+
+        // check if the element can be added (solid shapes, and images from the asset pages that are not cut into shapes)
+        bool Accepts(Element &element)
+        {
+            return element.Texture == nullptr || ((element.Shape == Shape::NONE || element.Shape == Shape::BOX) && Graphics::IsShared(element.Texture));
+        }
+
+        // add image of the element (see Graphics::RenderTexture)
+        void Image(Element &element)
+        {
+            auto x = element.Location.X;
+
+            auto y = element.Location.Y;
+
+            auto w = element.Dimensions.X;
+
+            auto h = element.Dimensions.Y;
+
+            if (element.Background != 0)
+            {
+                this->Rect(w, h, x, y, element.Background);
+            }
+
+            if (element.Border != 0)
+            {
+                this->Frame(w, h, x, y, element.Border);
+            }
+
+            auto bounds = std::min(h, element.TextureBounds);
+
+            if (w > 0 && bounds > 0)
+            {
+                auto white = Color::S(Color::White);
+
+                auto size = float(Asset::PageSize);
+
+                auto left = float(element.Source.X) / size;
+
+                auto top = float(element.Source.Y + element.TextureOffset) / size;
+
+                auto right = float(element.Source.X + w) / size;
+
+                auto bottom = float(element.Source.Y + element.TextureOffset + bounds) / size;
+
+                auto a = this->Vertex(SDL_FPoint{float(x), float(y)}, white, SDL_FPoint{left, top});
+
+                auto b = this->Vertex(SDL_FPoint{float(x + w), float(y)}, white, SDL_FPoint{right, top});
+
+                auto c = this->Vertex(SDL_FPoint{float(x + w), float(y + h)}, white, SDL_FPoint{right, bottom});
+
+                auto d = this->Vertex(SDL_FPoint{float(x), float(y + h)}, white, SDL_FPoint{left, bottom});
+
+                this->Quad(a, b, c, d);
+            }
+        }
+
+        // add element (same output as Graphics::Render)
+        void Add(Element &element)
+        {
+            if (element.Texture != nullptr)
+            {
+                this->Texture = element.Texture;
+
+                this->Image(element);
+
+                return;
+            }
+
+            switch (element.Shape)
+            {
+            case Shape::HEX:
+
+                if (element.Background != 0)
+                {
+                    this->Polygon(element.Hex, element.LocationOffset, element.Background);
+                }
+
+                if (element.Border != 0)
+                {
+                    this->Outline(element.Hex, Point(0, 0), element.Border);
+                }
+
+                break;
+
+            case Shape::BOX:
+
+                if (element.Background != 0)
+                {
+                    this->Rect(element.Dimensions.X, element.Dimensions.Y, element.Location.X, element.Location.Y, element.Background);
+                }
+
+                if (element.Border != 0 && element.Border != element.Background)
+                {
+                    // grow outward
+                    for (auto size = 0; size < element.BorderSize; size++)
+                    {
+                        auto p = (element.BorderSize - size);
+
+                        this->Frame(element.Dimensions.X + p * 2, element.Dimensions.Y + p * 2, element.Location.X - p, element.Location.Y - p, element.Border);
+                    }
+                }
+
+                break;
+
+            case Shape::CIRCLE:
+
+                // see Graphics::DrawCircle (called with the background as border color)
+                if (element.Radius > 0 && element.Border != 0)
+                {
+                    this->Disc(element.Location, float(element.Radius) - 0.5f, element.Border);
+                }
+
+                if (element.Radius > 0 && element.Background != element.Border)
+                {
+                    this->Ring(element.Location, float(element.Radius) - 1.0f, element.Background);
+                }
+
+                break;
+
+            default:
+
+                break;
+            }
+        }
+
+        // submit the triangles
+        void Flush(Base &graphics)
+        {
+            if (graphics.Renderer && !this->Indices.empty())
+            {
+                SDL_RenderGeometry(graphics.Renderer, this->Texture, this->Vertices.data(), int(this->Vertices.size()), this->Indices.data(), int(this->Indices.size()));
+
+                this->Calls++;
+            }
+
+            this->Vertices.clear();
+
+            this->Indices.clear();
+
+            this->Texture = nullptr;
+        }
+    };
+
+    // shared geometry buffers
+    Graphics::Batch Geometry = Graphics::Batch();
+#endif
+
+    // batch solid shapes with SDL_RenderGeometry toggle (only if SDL 2.0.18 or newer)
+    bool GeometryEnabled = true;
+
+    // render elements in order. runs of solid shapes and images from the same asset page are drawn with one SDL_RenderGeometry call if available
+    void Render(Base &graphics, Elements &elements)
+    {
+        auto batched = false;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+        if (Graphics::GeometryEnabled)
+        {
+            auto &batch = Graphics::Geometry;
+
+            for (auto &element : elements)
+            {
+                if (batch.Accepts(element))
+                {
+                    // a batch draws from one page only
+                    if (element.Texture != nullptr && batch.Texture != nullptr && batch.Texture != element.Texture)
+                    {
+                        batch.Flush(graphics);
+                    }
+
+                    batch.Add(element);
+                }
+                else
+                {
+                    // keep drawing order
+                    batch.Flush(graphics);
+
+                    Graphics::Render(graphics, element);
+                }
+            }
+
+            batch.Flush(graphics);
+
+            batched = true;
+        }
+#endif
+
+        if (!batched)
+        {
+            for (auto &element : elements)
+            {
+                Graphics::Render(graphics, element);
+            }
+        }
+    }
+
+    // area covered by the element on screen, from (first) up to but not including (last)
+    void Bounds(Element &element, Point &first, Point &last)
+    {
+        if (element.Shape == Shape::HEX && element.Hex.size() > 0)
+        {
+            first = element.Hex[0];
+
+            last = element.Hex[0];
+
+            for (auto &point : element.Hex)
+            {
+                first = Point(std::min(first.X, point.X), std::min(first.Y, point.Y));
+
+                last = Point(std::max(last.X, point.X), std::max(last.Y, point.Y));
+            }
+
+            first += element.LocationOffset;
+
+            last += element.LocationOffset + Point(1, 1);
+        }
+        else if (element.Shape == Shape::CIRCLE)
+        {
+            first = element.Location - element.Radius;
+
+            last = element.Location + (element.Radius + 1);
+        }
+        else if (element.Shape == Shape::BOX || element.Texture != nullptr)
+        {
+            first = element.Location;
+
+            last = element.Location + element.Dimensions;
+        }
+        else
+        {
+            // not rendered
+            first = element.Location;
+
+            last = element.Location;
+        }
+    }
+
+    // copy of the element moved by (offset)
+    Element Translate(Element element, Point offset)
+    {
+        element.Location += offset;
+
+        if (element.Shape == Shape::HEX)
+        {
+            if (element.Texture != nullptr)
+            {
+                // hex coordinates of textured hexes are relative to LocationOffset
+                element.LocationOffset += offset;
+            }
+            else
+            {
+                for (auto &point : element.Hex)
+                {
+                    point += offset;
+                }
+            }
+        }
+
+        return element;
+    }
+
+    // terrain of a map view pre-rendered into render-target textures. the layer is split into chunks so that a terrain change only redraws the chunks around it
+    class Layer
+    {
+    public:
+        // size of the chunks in pixels
+        int ChunkSize = 512;
+
+        // area covered by the layer on screen
+        Point Origin = Point(0, 0);
+
+        Point Dimensions = Point(0, 0);
+
+        // number of chunks along each axis
+        Point Chunks = Point(0, 0);
+
+        // chunk textures (row-major)
+        List<SDL_Texture *> Textures = {};
+
+        // flag if the chunk needs to be redrawn
+        List<std::uint8_t> Dirty = {};
+
+        // terrain elements of the map view (element index in the scene) and the area they cover
+        List<int> Items = {};
+
+        Points First = {};
+
+        Points Last = {};
+
+        // value of MapView::Builds / MapView::Version when the layer was last updated
+        unsigned int Builds = 0;
+
+        unsigned int Version = 0;
+
+        // number of chunks redrawn by the last update
+        int Redrawn = 0;
+
+        // chunk textures followed by the unit elements of the map view
+        DarkEmperor::Scene Scene = DarkEmperor::Scene();
+
+        Layer(int chunk_size) : ChunkSize(chunk_size) {}
+
+        Layer() {}
+
+        // release the chunk textures
+        void Destroy()
+        {
+            for (auto texture : this->Textures)
+            {
+                if (texture)
+                {
+                    SDL_DestroyTexture(texture);
+                }
+            }
+
+            this->Textures.clear();
+
+            this->Dirty.clear();
+
+            this->Chunks = Point(0, 0);
+        }
+
+        // create chunk textures covering (dimensions) pixels starting at (origin). returns false if render-target textures are not available
+        //
+        // if the number of chunks has not changed (e.g. the view has only scrolled), the textures are kept and only redrawn
+        bool Create(Graphics::Base &graphics, Point origin, Point dimensions)
+        {
+            auto chunks = Point((dimensions.X + this->ChunkSize - 1) / this->ChunkSize, (dimensions.Y + this->ChunkSize - 1) / this->ChunkSize);
+
+            if (chunks != this->Chunks)
+            {
+                this->Destroy();
+            }
+
+            this->Origin = origin;
+
+            this->Dimensions = dimensions;
+
+            auto created = graphics.Renderer && SDL_RenderTargetSupported(graphics.Renderer) && dimensions.X > 0 && dimensions.Y > 0;
+
+            if (created)
+            {
+                this->Chunks = chunks;
+
+                this->Textures.resize(this->Chunks.X * this->Chunks.Y, nullptr);
+
+                for (auto chunk = 0; chunk < this->Textures.size(); chunk++)
+                {
+                    auto size = this->Size(chunk);
+
+                    auto &texture = this->Textures[chunk];
+
+                    // chunks on the right and bottom edges may have changed size
+                    if (texture && (Asset::Width(texture) != size.X || Asset::Height(texture) != size.Y))
+                    {
+                        SDL_DestroyTexture(texture);
+
+                        texture = nullptr;
+                    }
+
+                    if (!texture)
+                    {
+                        texture = SDL_CreateTexture(graphics.Renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, size.X, size.Y);
+
+                        if (texture)
+                        {
+                            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+                        }
+                        else
+                        {
+                            created = false;
+                        }
+                    }
+                }
+
+                this->Dirty.assign(this->Textures.size(), 1);
+            }
+
+            if (!created)
+            {
+                this->Destroy();
+            }
+
+            return created;
+        }
+
+        // top-left corner of the chunk on screen
+        Point Location(int chunk)
+        {
+            return this->Origin + Point(chunk % this->Chunks.X, chunk / this->Chunks.X) * this->ChunkSize;
+        }
+
+        // dimensions of the chunk (chunks on the right and bottom edges may be smaller)
+        Point Size(int chunk)
+        {
+            auto location = this->Location(chunk) - this->Origin;
+
+            return Point(std::min(this->ChunkSize, this->Dimensions.X - location.X), std::min(this->ChunkSize, this->Dimensions.Y - location.Y));
+        }
+
+        // mark the chunks overlapping the area (first, last) for redrawing
+        void Invalidate(Point first, Point last)
+        {
+            if (!this->Textures.empty() && first.X < last.X && first.Y < last.Y)
+            {
+                auto from = (first - this->Origin) / this->ChunkSize;
+
+                auto to = (last - this->Origin - 1) / this->ChunkSize;
+
+                for (auto y = std::max(0, from.Y); y <= std::min(this->Chunks.Y - 1, to.Y); y++)
+                {
+                    for (auto x = std::max(0, from.X); x <= std::min(this->Chunks.X - 1, to.X); x++)
+                    {
+                        this->Dirty[y * this->Chunks.X + x] = 1;
+                    }
+                }
+            }
+        }
+
+        // mark all chunks for redrawing (e.g. when the renderer has lost the contents of its render targets)
+        void Invalidate()
+        {
+            this->Dirty.assign(this->Textures.size(), 1);
+        }
+
+        // redraw the dirty chunks with the terrain elements that overlap them
+        void Compose(Graphics::Base &graphics, Elements &elements)
+        {
+            this->Redrawn = 0;
+
+            auto target = SDL_GetRenderTarget(graphics.Renderer);
+
+            for (auto chunk = 0; chunk < this->Textures.size(); chunk++)
+            {
+                if (this->Dirty[chunk])
+                {
+                    auto location = this->Location(chunk);
+
+                    auto limit = location + this->Size(chunk);
+
+                    SDL_SetRenderTarget(graphics.Renderer, this->Textures[chunk]);
+
+                    Graphics::Clip(graphics);
+
+                    // clear to transparent
+                    SDL_SetRenderDrawColor(graphics.Renderer, 0, 0, 0, 0);
+
+                    SDL_RenderClear(graphics.Renderer);
+
+                    auto visible = Elements();
+
+                    for (auto item = 0; item < this->Items.size(); item++)
+                    {
+                        auto &first = this->First[item];
+
+                        auto &last = this->Last[item];
+
+                        if (first.X < limit.X && last.X > location.X && first.Y < limit.Y && last.Y > location.Y)
+                        {
+                            visible.push_back(Graphics::Translate(elements[this->Items[item]], Point(0, 0) - location));
+                        }
+                    }
+
+                    Graphics::Render(graphics, visible);
+
+                    this->Dirty[chunk] = 0;
+
+                    this->Redrawn++;
+                }
+            }
+
+            SDL_SetRenderTarget(graphics.Renderer, target);
+        }
+
+        // bring the layer up to date with the map view and return the scene to render. returns the scene of the map view if render-target textures are not available
+        DarkEmperor::Scene &Update(Graphics::Base &graphics, MapView &view)
+        {
+            auto &elements = view.Scene.Elements;
+
+            auto rebuilt = view.Builds != this->Builds;
+
+            if (rebuilt)
+            {
+                this->Items.clear();
+
+                this->First.clear();
+
+                this->Last.clear();
+
+                auto origin = Point(0, 0);
+
+                auto limit = Point(0, 0);
+
+                for (auto index = 0; index < view.Slots.size(); index++)
+                {
+                    if (view.Slots[index] >= 0)
+                    {
+                        // hex, terrain feature and outline
+                        for (auto slot = 0; slot < 3; slot++)
+                        {
+                            auto item = view.Slots[index] + slot;
+
+                            auto first = Point(0, 0);
+
+                            auto last = Point(0, 0);
+
+                            Graphics::Bounds(elements[item], first, last);
+
+                            if (first.X < last.X && first.Y < last.Y)
+                            {
+                                origin = this->Items.empty() ? first : Point(std::min(origin.X, first.X), std::min(origin.Y, first.Y));
+
+                                limit = this->Items.empty() ? last : Point(std::max(limit.X, last.X), std::max(limit.Y, last.Y));
+                            }
+
+                            this->Items.push_back(item);
+
+                            this->First.push_back(first);
+
+                            this->Last.push_back(last);
+                        }
+                    }
+                }
+
+                this->Create(graphics, origin, limit - origin);
+
+                this->Builds = view.Builds;
+            }
+            else
+            {
+                for (auto index : view.Repaint)
+                {
+                    if (view.Slots[index] >= 0)
+                    {
+                        // slots are in the same order as the items
+                        for (auto slot = 0; slot < 3; slot++)
+                        {
+                            auto item = (view.Slots[index] / TileSlots) * 3 + slot;
+
+                            // previous area of the element
+                            this->Invalidate(this->First[item], this->Last[item]);
+
+                            Graphics::Bounds(elements[this->Items[item]], this->First[item], this->Last[item]);
+
+                            this->Invalidate(this->First[item], this->Last[item]);
+                        }
+                    }
+                }
+            }
+
+            view.Repaint.clear();
+
+            this->Compose(graphics, elements);
+
+            if (!this->Textures.empty() && (rebuilt || this->Version != view.Version))
+            {
+                auto &scene = this->Scene;
+
+                scene.Background = view.Scene.Background;
+
+                scene.Clip = view.Scene.Clip;
+
+                scene.ClipDimensions = view.Scene.ClipDimensions;
+
+                if (rebuilt)
+                {
+                    scene.Controls = view.Scene.Controls;
+                }
+
+                scene.Elements.clear();
+
+                for (auto chunk = 0; chunk < this->Textures.size(); chunk++)
+                {
+                    auto element = Element();
+
+                    element.Texture = this->Textures[chunk];
+
+                    element.Location = this->Location(chunk);
+
+                    element.Dimensions = this->Size(chunk);
+
+                    element.TextureBounds = element.Dimensions.Y;
+
+                    scene.Elements.push_back(element);
+                }
+
+                // units are drawn over the terrain
+                for (auto index = 0; index < view.Slots.size(); index++)
+                {
+                    if (view.Slots[index] >= 0)
+                    {
+                        for (auto slot = 3; slot < TileSlots; slot++)
+                        {
+                            auto &element = elements[view.Slots[index] + slot];
+
+                            if (element.Shape != Shape::NONE || element.Texture != nullptr)
+                            {
+                                scene.Elements.push_back(element);
+                            }
+                        }
+                    }
+                }
+
+                this->Version = view.Version;
+            }
+
+            return this->Textures.empty() ? view.Scene : this->Scene;
+        }
+    };
+
+    // render overlay on screen
+    void Overlay(Base &graphics, Scene &scene)
+    {
+        if (graphics.Renderer)
+        {
+            if (!scene.Clip.IsNone())
+            {
+                // render only in visible areas
+                Graphics::Clip(graphics, scene.Clip, scene.ClipDimensions);
+            }
+            else
+            {
+                // reset clipping
+                Graphics::Clip(graphics);
+            }
+
+            Graphics::Render(graphics, scene.Elements);
         }
     }
 
@@ -249,7 +249,7 @@ int main(int argc, char **argv)
     {
         std::cerr << "To Use:" << std::endl
                   << std::endl
-                  << argv[0] << " [width] [height] [size in pixels] [flat/pointy orientation] [blind/boundary] [new/old/crop textures]" << std::endl;
+                  << argv[0] << " [width] [height] [size in pixels] [flat/pointy orientation] [blind/boundary] [new/old/crop textures] [sprites/lines (optional)]" << std::endl;
 
         exit(1);
     }
@@ -268,6 +268,9 @@ int main(int argc, char **argv)
 
     auto crop = DarkEmperor::Utilities::ToUpper(argv[6]) == "CROP";
 
+    // clip hex / circle textures line by line instead of using pre-cut sprites
+    DarkEmperor::Graphics::SpritesEnabled = !(argc > 7 && DarkEmperor::Utilities::ToUpper(argv[7]) == "LINES");
+
     DarkEmperor::Main(width, height, size, flat, blind, new_textures, crop);
 
     return 0;
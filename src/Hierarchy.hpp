@@ -0,0 +1,811 @@
+#ifndef __HIERARCHY_HPP__
+#define __HIERARCHY_HPP__
+
+#include "Move.hpp"
+
+// hierarchical path finding (HPA*) for large maps
+//
+// the map is split into clusters (the change tracking regions of the map). tiles on both sides of cluster borders become entrances,
+// and the costs between entrances of the same cluster are precomputed for each movement class (using a single unit).
+// paths are first found on the graph of entrances, then refined into tiles with Move::FindPath
+namespace DarkEmperor::Hierarchy
+{
+    // movement classes with their own abstract graph
+    const List<UnitType> Movements = {UnitType::GROUND, UnitType::NAVAL, UnitType::AIR};
+
+    // borders longer than this get two entrances (at both ends) instead of one in the middle
+    const int LongBorder = 6;
+
+    // movement class with the same passability as the stack, UnitType::NONE if there is none
+    UnitType Movement(Stack &units)
+    {
+        auto movement = UnitType::NONE;
+
+        auto mask = Passage(units);
+
+        for (auto type : Hierarchy::Movements)
+        {
+            auto matches = !units.empty();
+
+            for (auto passage : TerrainPassage)
+            {
+                if (DarkEmperor::IsPassable(passage, mask) != DarkEmperor::IsPassable(passage, Passage(type)))
+                {
+                    matches = false;
+
+                    break;
+                }
+            }
+
+            if (matches)
+            {
+                movement = type;
+
+                break;
+            }
+        }
+
+        return movement;
+    }
+
+    // edge of the abstract graph (cost of moving to another entrance)
+    class Link
+    {
+    public:
+        int Target = -1;
+
+        int Cost = 0;
+
+        Link(int target, int cost) : Target(target), Cost(cost) {}
+
+        Link() {}
+    };
+
+    typedef List<Hierarchy::Link> Links;
+
+    // abstract graph of a movement class
+    class Graph
+    {
+    public:
+        UnitType Movement = UnitType::NONE;
+
+        // passage mask of the movement class (passability is checked for a single unit)
+        PassageMask Mask = 0;
+
+        // map version of each cluster when it was last built (0 = never built)
+        List<unsigned int> Versions = {};
+
+        // entrance tiles of each cluster
+        List<List<int>> Entrances = {};
+
+        // links to entrances across cluster borders (indexed by tile)
+        List<Hierarchy::Links> Transitions = {};
+
+        // links to entrances within the same cluster (indexed by tile)
+        List<Hierarchy::Links> Paths = {};
+
+        // connected area of each tile within its cluster (first tile of the area, -1 if impassable)
+        List<int> Components = {};
+
+        // areas joined across cluster borders (union-find over Components, indexed by tile)
+        List<int> Roots = {};
+
+        // search state used when connecting entrances
+        Move::Workspace Search = Move::Workspace();
+
+        Graph(UnitType movement) : Movement(movement), Mask(Passage(movement)) {}
+
+        Graph() {}
+
+        bool IsPassable(Map &map, int index)
+        {
+            return Move::IsPassable(map, index, this->Mask, 1);
+        }
+
+        // tile is an entrance of its cluster
+        bool IsEntrance(int index)
+        {
+            return !this->Transitions[index].empty();
+        }
+
+        // first and last (exclusive) tile coordinates of the cluster
+        void Bounds(Map &map, int cluster, Point &first, Point &last)
+        {
+            first = Point((cluster % map.Regions.X) * map.RegionSize, (cluster / map.Regions.X) * map.RegionSize);
+
+            last = Point(std::min(first.X + map.RegionSize, map.Dimensions.X), std::min(first.Y + map.RegionSize, map.Dimensions.Y));
+        }
+
+        // discard the graph if the map layout has changed
+        void Resize(Map &map)
+        {
+            auto clusters = int(map.Versions.size());
+
+            if (int(this->Versions.size()) != clusters || int(this->Transitions.size()) != map.Area())
+            {
+                this->Versions.assign(clusters, 0);
+
+                this->Entrances.assign(clusters, {});
+
+                this->Transitions.assign(map.Area(), {});
+
+                this->Paths.assign(map.Area(), {});
+
+                this->Components.assign(map.Area(), -1);
+
+                this->Roots.assign(map.Area(), -1);
+
+                this->Search.Resize(map.Area());
+            }
+        }
+
+        // remove links from entrances of cluster into cluster (other)
+        void Disconnect(Map &map, int cluster, int other)
+        {
+            for (auto entrance : this->Entrances[cluster])
+            {
+                auto &links = this->Transitions[entrance];
+
+                links.erase(std::remove_if(links.begin(), links.end(), [&](Hierarchy::Link &link)
+                                           { return map.Region(link.Target) == other; }),
+                            links.end());
+            }
+        }
+
+        // add a pair of links across the border (a in one cluster, b in the other)
+        void Join(Map &map, int a, int b)
+        {
+            this->Transitions[a].push_back(Hierarchy::Link(b, Move::Cost(map, b)));
+
+            this->Transitions[b].push_back(Hierarchy::Link(a, Move::Cost(map, a)));
+        }
+
+        // rebuild entrances on the border between two neighboring clusters
+        void Connect(Map &map, int cluster, int other)
+        {
+            // always scan from the same side so entrances do not depend on which of the clusters changed
+            if (other < cluster)
+            {
+                std::swap(cluster, other);
+            }
+
+            this->Disconnect(map, cluster, other);
+
+            this->Disconnect(map, other, cluster);
+
+            auto first = Point();
+
+            auto last = Point();
+
+            this->Bounds(map, cluster, first, last);
+
+            // passable tile pairs across the border (every crossing of each tile), in scan order
+            auto inside = List<int>();
+
+            auto outside = List<int>();
+
+            for (auto y = first.Y; y < last.Y; y++)
+            {
+                for (auto x = first.X; x < last.X; x++)
+                {
+                    auto index = map.Index(x, y);
+
+                    if (!this->IsPassable(map, index))
+                    {
+                        continue;
+                    }
+
+                    for (auto neighbor : map.Adjacent(index))
+                    {
+                        if (map.Region(neighbor) == other && this->IsPassable(map, neighbor))
+                        {
+                            inside.push_back(index);
+
+                            outside.push_back(neighbor);
+                        }
+                    }
+                }
+            }
+
+            // group pairs into borders and place entrances on each. a border only continues while the tiles on both sides stay adjacent,
+            // so that any of its crossings can reach the others on either side (it is split wherever a crossing is blocked)
+            auto start = 0;
+
+            for (auto i = 1; i <= int(inside.size()); i++)
+            {
+                if (i == int(inside.size()) || map.IndexDistance(inside[i - 1], inside[i]) > 1 || map.IndexDistance(outside[i - 1], outside[i]) > 1)
+                {
+                    auto end = i - 1;
+
+                    if (end - start + 1 >= Hierarchy::LongBorder)
+                    {
+                        this->Join(map, inside[start], outside[start]);
+
+                        this->Join(map, inside[end], outside[end]);
+                    }
+                    else
+                    {
+                        auto middle = (start + end) / 2;
+
+                        this->Join(map, inside[middle], outside[middle]);
+                    }
+
+                    start = i;
+                }
+            }
+        }
+
+        // rebuild the entrance list and the links between entrances of a cluster
+        void Rebuild(Map &map, int cluster)
+        {
+            auto first = Point();
+
+            auto last = Point();
+
+            this->Bounds(map, cluster, first, last);
+
+            auto &entrances = this->Entrances[cluster];
+
+            entrances.clear();
+
+            for (auto y = first.Y; y < last.Y; y++)
+            {
+                for (auto x = first.X; x < last.X; x++)
+                {
+                    auto index = map.Index(x, y);
+
+                    this->Paths[index].clear();
+
+                    this->Components[index] = -1;
+
+                    if (this->IsEntrance(index))
+                    {
+                        entrances.push_back(index);
+                    }
+                }
+            }
+
+            // label the connected areas of the cluster
+            auto pending = List<int>();
+
+            for (auto y = first.Y; y < last.Y; y++)
+            {
+                for (auto x = first.X; x < last.X; x++)
+                {
+                    auto index = map.Index(x, y);
+
+                    if (this->Components[index] != -1 || !this->IsPassable(map, index))
+                    {
+                        continue;
+                    }
+
+                    this->Components[index] = index;
+
+                    pending.push_back(index);
+
+                    while (!pending.empty())
+                    {
+                        auto check = pending.back();
+
+                        pending.pop_back();
+
+                        for (auto node : map.Adjacent(check))
+                        {
+                            if (this->Components[node] == -1 && map.Region(node) == cluster && this->IsPassable(map, node))
+                            {
+                                this->Components[node] = index;
+
+                                pending.push_back(node);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // cheapest cost from each entrance to the others without leaving the cluster
+            for (auto entrance : entrances)
+            {
+                auto &workspace = this->Search;
+
+                auto &active = workspace.Active;
+
+                workspace.Reset(map);
+
+                workspace.Reach(entrance, 0, -1);
+
+                active.Push(entrance, 0);
+
+                while (!active.IsEmpty())
+                {
+                    auto check = active.Pop();
+
+                    workspace.Visit(check);
+
+                    if (check != entrance && this->IsEntrance(check))
+                    {
+                        this->Paths[entrance].push_back(Hierarchy::Link(check, workspace.Costs[check]));
+                    }
+
+                    for (auto node : map.Adjacent(check))
+                    {
+                        if (workspace.IsVisited(node) || map.Region(node) != cluster || !this->IsPassable(map, node))
+                        {
+                            continue;
+                        }
+
+                        auto cost = workspace.Costs[check] + Move::Cost(map, node);
+
+                        if (!workspace.IsReached(node) || cost < workspace.Costs[node])
+                        {
+                            workspace.Reach(node, cost, check);
+
+                            active.Push(node, cost);
+                        }
+                    }
+                }
+            }
+        }
+
+        // root of the union-find tree of an area
+        int Root(int component)
+        {
+            while (this->Roots[component] != component)
+            {
+                // halve the path on the way up
+                this->Roots[component] = this->Roots[this->Roots[component]];
+
+                component = this->Roots[component];
+            }
+
+            return component;
+        }
+
+        // join the areas of all clusters that are connected across borders
+        void Merge(Map &map)
+        {
+            for (auto index = 0; index < map.Area(); index++)
+            {
+                this->Roots[index] = index;
+            }
+
+            for (auto &entrances : this->Entrances)
+            {
+                for (auto entrance : entrances)
+                {
+                    for (auto &link : this->Transitions[entrance])
+                    {
+                        auto a = this->Root(this->Components[entrance]);
+
+                        auto b = this->Root(this->Components[link.Target]);
+
+                        if (a != b)
+                        {
+                            this->Roots[std::max(a, b)] = std::min(a, b);
+                        }
+                    }
+                }
+            }
+        }
+
+        // a single unit could move from start to end (start itself may be impassable, e.g. a full tile)
+        bool IsReachable(Map &map, int start, int end)
+        {
+            auto reachable = (start == end);
+
+            if (!reachable && this->IsPassable(map, end))
+            {
+                auto component = this->Root(this->Components[end]);
+
+                reachable = this->IsPassable(map, start) && this->Root(this->Components[start]) == component;
+
+                for (auto node : map.Adjacent(start))
+                {
+                    reachable |= this->IsPassable(map, node) && this->Root(this->Components[node]) == component;
+                }
+            }
+
+            return reachable;
+        }
+
+        // bring the graph up to date with the map (only clusters that changed and their neighbors are rebuilt)
+        void Update(Map &map)
+        {
+            this->Resize(map);
+
+            auto clusters = int(this->Versions.size());
+
+            auto changed = List<bool>(clusters, false);
+
+            auto rebuild = List<bool>(clusters, false);
+
+            auto any = false;
+
+            for (auto cluster = 0; cluster < clusters; cluster++)
+            {
+                changed[cluster] = (this->Versions[cluster] != map.Versions[cluster]);
+
+                any |= changed[cluster];
+            }
+
+            if (any)
+            {
+                for (auto cluster = 0; cluster < clusters; cluster++)
+                {
+                    if (!changed[cluster])
+                    {
+                        continue;
+                    }
+
+                    auto cx = cluster % map.Regions.X;
+
+                    auto cy = cluster / map.Regions.X;
+
+                    // hex neighbors in offset coordinates can lie in any of the eight surrounding clusters
+                    for (auto y = std::max(0, cy - 1); y <= std::min(map.Regions.Y - 1, cy + 1); y++)
+                    {
+                        for (auto x = std::max(0, cx - 1); x <= std::min(map.Regions.X - 1, cx + 1); x++)
+                        {
+                            auto other = y * map.Regions.X + x;
+
+                            // borders between two changed clusters are rebuilt only once
+                            if (other != cluster && (!changed[other] || cluster < other))
+                            {
+                                this->Connect(map, cluster, other);
+
+                                rebuild[other] = true;
+                            }
+                        }
+                    }
+
+                    rebuild[cluster] = true;
+                }
+
+                for (auto cluster = 0; cluster < clusters; cluster++)
+                {
+                    if (rebuild[cluster])
+                    {
+                        this->Rebuild(map, cluster);
+                    }
+
+                    if (changed[cluster])
+                    {
+                        this->Versions[cluster] = map.Versions[cluster];
+                    }
+                }
+
+                this->Merge(map);
+            }
+        }
+    };
+
+    // hierarchical path finder for a map (not thread-safe, use one per thread)
+    class Base
+    {
+    public:
+        // abstract graphs (in the same order as Movements)
+        List<Hierarchy::Graph> Graphs = {};
+
+        // search state of the abstract graph
+        Move::Workspace Abstract = Move::Workspace();
+
+        // search state used within the source and destination clusters, and for refining paths
+        Move::Workspace Local = Move::Workspace();
+
+        // links from the source to entrances of its cluster
+        Hierarchy::Links Starts = {};
+
+        // refined path between two entrances
+        Move::Path Segment = Move::Path();
+
+        Base()
+        {
+            for (auto movement : Hierarchy::Movements)
+            {
+                this->Graphs.push_back(Hierarchy::Graph(movement));
+            }
+        }
+
+        // abstract graph of a movement class (nullptr if none)
+        Hierarchy::Graph *Find(UnitType movement)
+        {
+            Hierarchy::Graph *graph = nullptr;
+
+            for (auto &search : this->Graphs)
+            {
+                if (search.Movement == movement)
+                {
+                    graph = &search;
+
+                    break;
+                }
+            }
+
+            return graph;
+        }
+
+        // costs from the source to the entrances of its cluster
+        //
+        // the source itself is not part of the graph if the stack could not enter it (e.g. a full tile), so it is not always
+        // connected to the rest of its cluster. its first step may then lead into a neighboring cluster, whose entrances are used instead
+        void Leave(Map &map, Hierarchy::Graph &graph, int start, Stack &units)
+        {
+            auto &workspace = this->Local;
+
+            auto &active = workspace.Active;
+
+            this->Starts.clear();
+
+            auto mask = Passage(units);
+
+            auto size = int(units.size());
+
+            workspace.Reset(map);
+
+            workspace.Reach(start, 0, -1);
+
+            active.Push(start, 0);
+
+            while (!active.IsEmpty())
+            {
+                auto check = active.Pop();
+
+                workspace.Visit(check);
+
+                if (check != start && graph.IsEntrance(check))
+                {
+                    this->Starts.push_back(Hierarchy::Link(check, workspace.Costs[check]));
+                }
+
+                for (auto node : map.Adjacent(check))
+                {
+                    if (workspace.IsVisited(node) || (check != start && map.Region(node) != map.Region(check)) || !Move::IsPassable(map, node, mask, size))
+                    {
+                        continue;
+                    }
+
+                    auto cost = workspace.Costs[check] + Move::Cost(map, node);
+
+                    if (!workspace.IsReached(node) || cost < workspace.Costs[node])
+                    {
+                        workspace.Reach(node, cost, check);
+
+                        active.Push(node, cost);
+                    }
+                }
+            }
+        }
+
+        // costs from the tiles of its cluster to the destination (searching backwards, results are kept in the local workspace)
+        void Enter(Map &map, int end, Stack &units)
+        {
+            auto &workspace = this->Local;
+
+            auto &active = workspace.Active;
+
+            auto cluster = map.Region(end);
+
+            auto mask = Passage(units);
+
+            auto size = int(units.size());
+
+            workspace.Reset(map);
+
+            if (Move::IsPassable(map, end, mask, size))
+            {
+                workspace.Reach(end, 0, -1);
+
+                active.Push(end, 0);
+            }
+
+            while (!active.IsEmpty())
+            {
+                auto check = active.Pop();
+
+                workspace.Visit(check);
+
+                for (auto node : map.Adjacent(check))
+                {
+                    if (workspace.IsVisited(node) || map.Region(node) != cluster || !Move::IsPassable(map, node, mask, size))
+                    {
+                        continue;
+                    }
+
+                    // moving from node into check costs the same regardless of the direction of the search
+                    auto cost = workspace.Costs[check] + Move::Cost(map, check);
+
+                    if (!workspace.IsReached(node) || cost < workspace.Costs[node])
+                    {
+                        workspace.Reach(node, cost, check);
+
+                        active.Push(node, cost);
+                    }
+                }
+            }
+        }
+
+        // find path from src to dst, reusing the storage of path
+        //
+        // paths are not always the cheapest (entrances are only placed at some tiles of each border). stacks without a matching
+        // movement class, or within the same cluster, use Move::FindPath directly. destinations in another connected area are
+        // rejected without searching (path.Closest is then the source), otherwise path.Closest is the entrance nearest to it
+        void FindPath(Map &map, Point src, Point dst, Stack &units, Move::Path &path)
+        {
+            path.Points.clear();
+
+            path.Closest = Point(-1, -1);
+
+            auto valid = map.IsValid(src) && map.IsValid(dst);
+
+            auto graph = this->Find(Hierarchy::Movement(units));
+
+            if (!valid || graph == nullptr)
+            {
+                Move::FindPath(map, src, dst, units, this->Local, path);
+
+                return;
+            }
+
+            graph->Update(map);
+
+            auto start = map.Index(src);
+
+            auto end = map.Index(dst);
+
+            if (!graph->IsReachable(map, start, end))
+            {
+                path.Closest = src;
+
+                return;
+            }
+
+            if (map.Region(start) == map.Region(end))
+            {
+                Move::FindPath(map, src, dst, units, this->Local, path);
+
+                return;
+            }
+
+            this->Leave(map, *graph, start, units);
+
+            this->Enter(map, end, units);
+
+            auto target = map.Region(end);
+
+            auto mask = Passage(units);
+
+            auto size = int(units.size());
+
+            auto &workspace = this->Abstract;
+
+            auto &active = workspace.Active;
+
+            workspace.Reset(map);
+
+            workspace.Reach(start, 0, -1);
+
+            auto min_distance = map.IndexDistance(start, end);
+
+            active.Push(start, min_distance);
+
+            path.Closest = src;
+
+            auto found = false;
+
+            // A* on the graph of entrances (each node is the tile index of an entrance)
+            while (!active.IsEmpty())
+            {
+                auto check = active.Pop();
+
+                if (check == end)
+                {
+                    found = true;
+
+                    break;
+                }
+
+                workspace.Visit(check);
+
+                auto dist = map.IndexDistance(check, end);
+
+                if (dist < min_distance)
+                {
+                    path.Closest = map.Location(check);
+
+                    min_distance = dist;
+                }
+
+                auto visit = [&](int node, int step)
+                {
+                    if (!workspace.IsVisited(node))
+                    {
+                        auto cost = workspace.Costs[check] + step;
+
+                        if (!workspace.IsReached(node) || cost < workspace.Costs[node])
+                        {
+                            workspace.Reach(node, cost, check);
+
+                            active.Push(node, cost + map.IndexDistance(node, end));
+                        }
+                    }
+                };
+
+                for (auto &link : (check == start ? this->Starts : graph->Paths[check]))
+                {
+                    visit(link.Target, link.Cost);
+                }
+
+                for (auto &link : graph->Transitions[check])
+                {
+                    // entrances are checked with a single unit, so the stack might not be able to cross
+                    if (Move::IsPassable(map, link.Target, mask, size))
+                    {
+                        visit(link.Target, link.Cost);
+                    }
+                }
+
+                // entrances of the destination cluster connect to the destination
+                if (map.Region(check) == target && this->Local.IsVisited(check))
+                {
+                    visit(end, this->Local.Costs[check]);
+                }
+            }
+
+            // the graph is built for a single unit, larger stacks might only get through at tiles without entrances
+            auto fallback = (size > 1);
+
+            if (found)
+            {
+                auto nodes = List<int>();
+
+                for (auto node = end; node != -1; node = workspace.Parents[node])
+                {
+                    nodes.push_back(node);
+                }
+
+                std::reverse(nodes.begin(), nodes.end());
+
+                // refine each step of the abstract path into tiles
+                for (auto i = 1; i < int(nodes.size()); i++)
+                {
+                    Move::FindPath(map, map.Location(nodes[i - 1]), map.Location(nodes[i]), units, this->Local, this->Segment);
+
+                    if (this->Segment.Points.empty())
+                    {
+                        path.Points.clear();
+
+                        path.Closest = src;
+
+                        // the stack does not fit somewhere along the abstract path
+                        if (fallback)
+                        {
+                            Move::FindPath(map, src, dst, units, this->Local, path);
+                        }
+
+                        return;
+                    }
+
+                    path.Points.insert(path.Points.end(), this->Segment.Points.begin() + (path.Points.empty() ? 0 : 1), this->Segment.Points.end());
+                }
+
+                path.Closest = dst;
+            }
+            else if (fallback)
+            {
+                // the entrances do not connect the clusters for this stack, search the whole map
+                Move::FindPath(map, src, dst, units, this->Local, path);
+            }
+        }
+
+        // find path from src to dst
+        Move::Path FindPath(Map &map, Point src, Point dst, Stack &units)
+        {
+            auto path = Move::Path();
+
+            this->FindPath(map, src, dst, units, path);
+
+            return path;
+        }
+    };
+}
+
+#endif
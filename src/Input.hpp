@@ -223,6 +223,8 @@ namespace DarkEmperor::Input
 
         input.Down = false;
 
+        input.Reset = false;
+
         if (result.type == SDL_QUIT)
         {
             input.Quit = true;
@@ -231,6 +233,13 @@ namespace DarkEmperor::Input
         {
             Graphics::HandleWindowEvent(result, graphics);
         }
+        else if (result.type == SDL_RENDER_TARGETS_RESET || result.type == SDL_RENDER_DEVICE_RESET)
+        {
+            // the contents of the atlas are lost, it is created (and cleared) again and its sprites are cut again when next used
+            Graphics::Sprites.Destroy();
+
+            input.Reset = true;
+        }
         else if (result.type == SDL_CONTROLLERDEVICEADDED)
         {
             Input::InitializeGamePads();
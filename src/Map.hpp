@@ -1,7 +1,9 @@
 #ifndef __MAP__
 #define __MAP__
 
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <vector>
 
 #include "Unit.hpp"
@@ -65,6 +67,12 @@ namespace DarkEmperor
         bool IsValid() { return this->Sum() == 0; }
     };
 
+    // distance between two cube coordinates (no validation)
+    inline int Distance(const Cube &src, const Cube &dst)
+    {
+        return (std::abs(src.Q - dst.Q) + std::abs(src.R - dst.R) + std::abs(src.S - dst.S)) / 2;
+    }
+
     class Tile
     {
     public:
@@ -103,6 +111,12 @@ namespace DarkEmperor
         // tile background
         Uint32 Background = 0;
 
+        // number of units of each kingdom on this tile (maintained by Map::Put / Map::Remove)
+        std::array<int, TotalKingdoms> Occupants = {};
+
+        // number of units affiliated with any kingdom on this tile
+        int Affiliated = 0;
+
         void Initialize(int x, int y, bool flat)
         {
             this->Point = DarkEmperor::Point(x, y);
@@ -165,29 +179,13 @@ namespace DarkEmperor
         // check if location is traversable or if it is the target destination
         bool IsPassable(UnitType type)
         {
-            return DarkEmperor::In(AllowedPassage[this->Terrain], type);
+            return DarkEmperor::IsPassable(this->Terrain, type);
         }
 
+        // check if all units in the stack can traverse this location
         bool IsPassable(Stack &units)
         {
-            auto passable = true;
-
-            auto types = List<UnitType>();
-
-            for (auto unit : units)
-            {
-                if (!DarkEmperor::In(types, unit.Type))
-                {
-                    types.push_back(unit.Type);
-                }
-            }
-
-            for (auto type : types)
-            {
-                passable &= this->IsPassable(type);
-            }
-
-            return passable;
+            return DarkEmperor::IsPassable(Passage(this->Terrain), Passage(units));
         }
 
         // check if tile is blocked
@@ -202,17 +200,34 @@ namespace DarkEmperor
             return (this->Units.size() == 0);
         }
 
-        // count other units belonging to "kingdom"
-        int Count(Kingdom kingdom)
+        // add (count = 1) or remove (count = -1) a unit of kingdom from the counters
+        void Occupy(Kingdom kingdom, int count)
         {
-            auto count = 0;
+            if (kingdom != Kingdom::NONE)
+            {
+                this->Occupants[int(kingdom)] += count;
 
-            for (auto unit : this->Units)
+                this->Affiliated += count;
+            }
+        }
+
+        // recount units from the stack
+        void Recount()
+        {
+            this->Occupants.fill(0);
+
+            this->Affiliated = 0;
+
+            for (auto &unit : this->Units)
             {
-                count += (unit.Kingdom != Kingdom::NONE && unit.Kingdom == kingdom ? 1 : 0);
+                this->Occupy(unit.Kingdom, 1);
             }
+        }
 
-            return count;
+        // count other units belonging to "kingdom"
+        int Count(Kingdom kingdom)
+        {
+            return kingdom != Kingdom::NONE ? this->Occupants[int(kingdom)] : 0;
         }
 
         // count other units belonging to "kingdom"
@@ -224,20 +239,254 @@ namespace DarkEmperor
         // count other units not belonging to "kingdom"
         int Others(Kingdom kingdom)
         {
-            auto count = 0;
+            return this->Affiliated - this->Count(kingdom);
+        }
+
+        // count other units
+        int Others()
+        {
+            return this->Others(this->Owner);
+        }
+    };
+
+    // non-allocating view over the neighbors of a tile in the neighbor table (skips -1 entries)
+    class Neighborhood
+    {
+    public:
+        class Iterator
+        {
+        public:
+            const int *Current = nullptr;
+
+            const int *Last = nullptr;
 
-            for (auto unit : this->Units)
+            Iterator(const int *current, const int *last) : Current(current), Last(last)
             {
-                count += (unit.Kingdom != Kingdom::NONE && unit.Kingdom != kingdom ? 1 : 0);
+                this->Skip();
+            }
+
+            // skip entries for neighbors outside the map
+            void Skip()
+            {
+                while (this->Current != this->Last && *this->Current < 0)
+                {
+                    this->Current++;
+                }
             }
 
-            return count;
+            int operator*() const
+            {
+                return *this->Current;
+            }
+
+            Iterator &operator++()
+            {
+                this->Current++;
+
+                this->Skip();
+
+                return *this;
+            }
+
+            bool operator!=(const Iterator &other) const
+            {
+                return this->Current != other.Current;
+            }
+        };
+
+        const int *First = nullptr;
+
+        const int *Last = nullptr;
+
+        Neighborhood(const int *first, const int *last) : First(first), Last(last) {}
+
+        Iterator begin() const
+        {
+            return Iterator(this->First, this->Last);
         }
 
-        // count other units
-        int Others()
+        Iterator end() const
         {
-            return this->Others(this->Owner);
+            return Iterator(this->Last, this->Last);
+        }
+    };
+
+    // structure-of-arrays view of the tile state used by the game rules (indexed by tile)
+    //
+    // kept in sync by Map::Put, Map::Remove and the Map setters. call Map::Synchronize after editing tiles directly
+    class RulesView
+    {
+    public:
+        List<TerrainType> Terrain = {};
+
+        List<Kingdom> Owner = {};
+
+        List<int> StackLimit = {};
+
+        List<int> Attrition = {};
+
+        List<int> CityValue = {};
+
+        // unit types allowed on each tile
+        List<PassageMask> Passage = {};
+
+        // stack limit of each tile (including the city value)
+        List<int> Capacity = {};
+
+        // number of units on each tile
+        List<int> Units = {};
+
+        // number of units affiliated with a kingdom on each tile
+        List<int> Affiliated = {};
+
+        // number of units of each kingdom on each tile (tile * TotalKingdoms + kingdom)
+        List<int> Occupancy = {};
+
+        // zone of control: number of units of each kingdom on each tile and its neighbors (tile * TotalKingdoms + kingdom)
+        List<int> Presence = {};
+
+        // zone of control: number of units affiliated with a kingdom on each tile and its neighbors
+        List<int> Nearby = {};
+
+        RulesView() {}
+
+        void Resize(int size)
+        {
+            this->Terrain.assign(size, TerrainType::NONE);
+
+            this->Owner.assign(size, Kingdom::NONE);
+
+            this->StackLimit.assign(size, 0);
+
+            this->Attrition.assign(size, 0);
+
+            this->CityValue.assign(size, 0);
+
+            this->Passage.assign(size, 0);
+
+            this->Capacity.assign(size, 0);
+
+            this->Units.assign(size, 0);
+
+            this->Affiliated.assign(size, 0);
+
+            this->Occupancy.assign(size * TotalKingdoms, 0);
+
+            this->Presence.assign(size * TotalKingdoms, 0);
+
+            this->Nearby.assign(size, 0);
+        }
+
+        // copy tile settings (terrain, owner, limits) into the view
+        void Synchronize(int index, Tile &tile)
+        {
+            this->Terrain[index] = tile.Terrain;
+
+            this->Owner[index] = tile.Owner;
+
+            this->StackLimit[index] = tile.StackLimit;
+
+            this->Attrition[index] = tile.Attrition;
+
+            this->CityValue[index] = tile.CityValue;
+
+            this->Passage[index] = DarkEmperor::Passage(tile.Terrain);
+
+            this->Capacity[index] = tile.StackLimit + (tile.IsCity() ? tile.CityValue : 0);
+        }
+
+        // add (count = 1) or remove (count = -1) a unit of kingdom on tile
+        void Occupy(int index, Kingdom kingdom, int count)
+        {
+            this->Units[index] += count;
+
+            if (kingdom != Kingdom::NONE)
+            {
+                this->Affiliated[index] += count;
+
+                this->Occupancy[index * TotalKingdoms + int(kingdom)] += count;
+            }
+        }
+
+        // add (count = 1) or remove (count = -1) a unit of kingdom within the zone of control of a tile
+        void Influence(int index, Kingdom kingdom, int count)
+        {
+            this->Nearby[index] += count;
+
+            this->Presence[index * TotalKingdoms + int(kingdom)] += count;
+        }
+
+        // check if no units other than those of "kingdom" are on this tile or its neighbors
+        bool IsControlled(int index, Kingdom kingdom)
+        {
+            auto own = kingdom != Kingdom::NONE ? this->Presence[index * TotalKingdoms + int(kingdom)] : 0;
+
+            return this->Nearby[index] == own;
+        }
+
+        // count units belonging to "kingdom"
+        int Count(int index, Kingdom kingdom)
+        {
+            return kingdom != Kingdom::NONE ? this->Occupancy[index * TotalKingdoms + int(kingdom)] : 0;
+        }
+
+        // count units not belonging to "kingdom"
+        int Others(int index, Kingdom kingdom)
+        {
+            return this->Affiliated[index] - this->Count(index, kingdom);
+        }
+
+        bool IsCity(int index)
+        {
+            return this->Terrain[index] == TerrainType::CITY || this->Terrain[index] == TerrainType::CAPITAL_CITY;
+        }
+
+        bool IsBlocked(int index)
+        {
+            return this->Terrain[index] == TerrainType::NONE;
+        }
+
+        // can fit stack of size
+        bool CanFitStack(int index, int size)
+        {
+            return size <= (this->Capacity[index] - this->Units[index]);
+        }
+
+        // check if all units in the stack can traverse this tile
+        bool IsPassable(int index, Stack &units)
+        {
+            return DarkEmperor::IsPassable(this->Passage[index], DarkEmperor::Passage(units));
+        }
+
+        // check if a stack of size with unit types in mask can enter this tile
+        bool CanEnter(int index, PassageMask mask, int size)
+        {
+            return !this->IsBlocked(index) && DarkEmperor::IsPassable(this->Passage[index], mask) && this->CanFitStack(index, size);
+        }
+
+        // check CanEnter for (count) consecutive tiles starting at (first), e.g. a row of the map (1 = passable)
+        //
+        // written without branches over the flat arrays so that the compiler can vectorize it
+        void CanEnter(int first, int count, PassageMask mask, int size, std::uint8_t *passable)
+        {
+            auto passage = this->Passage.data() + first;
+
+            auto terrain = this->Terrain.data() + first;
+
+            auto capacity = this->Capacity.data() + first;
+
+            auto units = this->Units.data() + first;
+
+            for (auto i = 0; i < count; i++)
+            {
+                auto allowed = (passage[i] & mask) == mask;
+
+                auto open = terrain[i] != TerrainType::NONE;
+
+                auto fits = size <= capacity[i] - units[i];
+
+                passable[i] = std::uint8_t(allowed & open & fits);
+            }
         }
     };
 
@@ -262,21 +511,70 @@ namespace DarkEmperor
         // size of the tiles in pixels
         int Size;
 
-        // tiles comprising the map
-        Array<Tile> Tiles = {};
+        // tiles comprising the map (contiguous, row-major)
+        List<Tile> Tiles = {};
+
+        // hex number to tile index lookup (see Find)
+        UnorderedMap<int, int> Ids = {};
+
+        // six neighbor tile indices per tile (in offset order), -1 if outside the map
+        List<int> Adjacency = {};
+
+        // dense copy of the tile state used by the game rules
+        RulesView Rules = RulesView();
+
+        // cube coordinates of each tile
+        List<Cube> Cubes = {};
+
+        // optional all-pairs distance table (src * Area() + dst), see PrecomputeDistances
+        List<std::uint8_t> Distances = {};
+
+        // size (in tiles) of the square regions used to track changes to the map
+        int RegionSize = 16;
+
+        // number of regions along each axis
+        Point Regions = Point(0, 0);
+
+        // change counter, incremented whenever a tile or the units on it change
+        unsigned int Version = 0;
+
+        // value of the change counter when each region was last changed
+        List<unsigned int> Versions = {};
+
+        // tiles changed since the last call to Clean (each tile is listed once)
+        List<int> Dirty = {};
+
+        // flag if the tile is in the dirty list
+        List<std::uint8_t> IsDirty = {};
+
+        // tile index of each unit on the map (indexed by unit id), -1 if the unit is not on the map. maintained by Put / Remove, rebuilt by Synchronize
+        List<int> Placements = {};
 
         Map(int width, int height, int size, bool flat) : Dimensions(width, height), Flat(flat), Size(size)
         {
-            this->Tiles = std::vector(height, std::vector(width, DarkEmperor::Tile()));
+            this->Tiles = List<Tile>(width * height, DarkEmperor::Tile());
 
             for (auto y = 0; y < height; y++)
             {
                 for (auto x = 0; x < width; x++)
                 {
-                    this->Tiles[y][x].Initialize(x, y, this->Flat);
+                    this->Tiles[this->Index(x, y)].Initialize(x, y, this->Flat);
                 }
             }
 
+            this->Cubes = List<Cube>(this->Area());
+
+            for (auto index = 0; index < this->Area(); index++)
+            {
+                this->Cubes[index] = this->Tiles[index].Hex;
+            }
+
+            this->InitializeNeighbors();
+
+            this->InitializeRegions();
+
+            this->Synchronize();
+
             this->Draw = Point(0, 0);
 
             this->View = Point(0, 0);
@@ -291,7 +589,7 @@ namespace DarkEmperor
         // access location on the map
         Tile &operator()(int x, int y)
         {
-            return this->Tiles[y][x];
+            return this->Tiles[this->Index(x, y)];
         }
 
         // access location on the map
@@ -338,45 +636,148 @@ namespace DarkEmperor
             return this->IsValid(point.X, point.Y);
         }
 
+        // number of tiles on the map
+        int Area()
+        {
+            return this->Dimensions.X * this->Dimensions.Y;
+        }
+
+        // convert (x, y) into a flat tile index (row-major)
+        int Index(int x, int y)
+        {
+            return y * this->Dimensions.X + x;
+        }
+
+        // convert point into a flat tile index (row-major)
+        int Index(Point point)
+        {
+            return this->Index(point.X, point.Y);
+        }
+
+        // convert flat tile index back into map coordinates
+        Point Location(int index)
+        {
+            return Point(index % this->Dimensions.X, index / this->Dimensions.X);
+        }
+
+        // access location on the map using flat tile index
+        Tile &At(int index)
+        {
+            return this->Tiles[index];
+        }
+
+        // rebuild hex number lookup (first tile wins if numbers repeat)
+        void InitializeIds()
+        {
+            this->Ids.clear();
+
+            for (auto index = 0; index < this->Tiles.size(); index++)
+            {
+                this->Ids.emplace(this->Tiles[index].Id, index);
+            }
+        }
+
+        // assign hex number to the tile at point
+        void SetId(Point point, int id)
+        {
+            if (this->IsValid(point))
+            {
+                auto index = this->Index(point);
+
+                this->Tiles[index].Id = id;
+
+                this->Ids[id] = index;
+            }
+        }
+
+        // index of the tile with hex number (id), -1 if none
+        int Find(int id)
+        {
+            auto found = this->Ids.find(id);
+
+            // hex numbers may also be assigned directly on the tiles, so rebuild the lookup if it is stale
+            if (found == this->Ids.end() || this->Tiles[found->second].Id != id)
+            {
+                this->InitializeIds();
+
+                found = this->Ids.find(id);
+            }
+
+            return found != this->Ids.end() ? found->second : -1;
+        }
+
+        // map coordinates of the tile with hex number (id)
         Point operator[](int id)
         {
-            auto point = Point(-1, -1);
+            auto index = this->Find(id);
+
+            return index >= 0 ? this->Location(index) : Point(-1, -1);
+        }
+
+        // return set of neighbors
+        Points Neighbors(bool is_odd = false)
+        {
+            return this->Offsets(is_odd);
+        }
+
+        // return set of neighbor offsets (without copying)
+        const Points &Offsets(bool is_odd)
+        {
+            return this->Flat ? (is_odd ? DarkEmperor::FlatNeighborsOdd : DarkEmperor::FlatNeighbors) : (is_odd ? DarkEmperor::PointyNeighborsOdd : DarkEmperor::PointyNeighbors);
+        }
+
+        // return set of neighbor offsets for point (x, y)
+        const Points &Offsets(int x, int y)
+        {
+            return this->Offsets(this->Flat ? ((x & 1) != 0) : ((y & 1) != 0));
+        }
+
+        // precompute neighbor table
+        void InitializeNeighbors()
+        {
+            this->Adjacency.assign(this->Area() * 6, -1);
 
-            for (auto y = 0; y < this->Tiles.size(); y++)
+            for (auto y = 0; y < this->Dimensions.Y; y++)
             {
-                for (auto x = 0; x < this->Tiles[y].size(); x++)
+                for (auto x = 0; x < this->Dimensions.X; x++)
                 {
-                    if (this->Tiles[y][x].Id == id)
+                    auto &offsets = this->Offsets(x, y);
+
+                    auto index = this->Index(x, y);
+
+                    for (auto direction = 0; direction < 6; direction++)
                     {
-                        point = Point(x, y);
+                        auto point = Point(x, y) + offsets[direction];
 
-                        break;
+                        if (this->IsValid(point))
+                        {
+                            this->Adjacency[index * 6 + direction] = this->Index(point);
+                        }
                     }
                 }
-
-                if (!point.IsNone())
-                {
-                    break;
-                }
             }
+        }
+
+        // indices of all valid neighbors of tile (from the precomputed table)
+        Neighborhood Adjacent(int index)
+        {
+            auto first = this->Adjacency.data() + index * 6;
 
-            return point;
+            return Neighborhood(first, first + 6);
         }
 
-        // return set of neighbors
-        Points Neighbors(bool is_odd = false)
+        // index of the neighbor of tile in the given direction, -1 if none
+        int Adjacent(int index, int direction)
         {
-            return this->Flat ? (is_odd ? DarkEmperor::FlatNeighborsOdd : DarkEmperor::FlatNeighbors) : (is_odd ? DarkEmperor::PointyNeighborsOdd : DarkEmperor::PointyNeighbors);
+            return this->Adjacency[index * 6 + direction];
         }
 
         // get all valid neighbors of point (x, y)
         Points Neighbors(int x, int y)
         {
-            auto is_odd = this->Flat ? ((x & 1) != 0) : ((y & 1) != 0);
-
             auto neighbors = Points();
 
-            for (auto neighbor : this->Neighbors(is_odd))
+            for (auto &neighbor : this->Offsets(x, y))
             {
                 auto point = Point(x, y) + neighbor;
 
@@ -402,33 +803,258 @@ namespace DarkEmperor
 
             if (this->IsValid(x0, y0) && this->IsValid(x1, y1))
             {
-                auto &src = this->Tiles[y0][x0].Hex;
+                distance = this->IndexDistance(this->Index(x0, y0), this->Index(x1, y1));
+            }
+
+            return distance;
+        }
+
+        // calculate distance between two points
+        int Distance(Point src, Point dst)
+        {
+            return this->Distance(src.X, src.Y, dst.X, dst.Y);
+        }
+
+        // distance between two tiles (flat indices, not validated)
+        int IndexDistance(int src, int dst)
+        {
+            if (!this->Distances.empty())
+            {
+                return this->Distances[src * this->Area() + dst];
+            }
 
-                auto &dst = this->Tiles[y1][x1].Hex;
+            return DarkEmperor::Distance(this->Cubes[src], this->Cubes[dst]);
+        }
 
-                auto q = std::abs(src.Q - dst.Q);
+        // precompute all-pairs distance table if the map has at most (limit) tiles. returns true if the table is available
+        //
+        // must be called before any parallel searches since it modifies the map
+        bool PrecomputeDistances(int limit = 2048)
+        {
+            auto area = this->Area();
 
-                auto r = std::abs(src.R - dst.R);
+            // distances must fit in a byte
+            auto fits = (this->Dimensions.X + this->Dimensions.Y) < 256;
 
-                auto s = std::abs(src.S - dst.S);
+            if (this->Distances.empty() && area > 0 && area <= limit && fits)
+            {
+                auto distances = List<std::uint8_t>(area * area);
 
-                distance = (q + r + s) / 2;
+                for (auto src = 0; src < area; src++)
+                {
+                    for (auto dst = 0; dst < area; dst++)
+                    {
+                        distances[src * area + dst] = std::uint8_t(DarkEmperor::Distance(this->Cubes[src], this->Cubes[dst]));
+                    }
+                }
+
+                this->Distances = std::move(distances);
             }
 
-            return distance;
+            return !this->Distances.empty();
         }
 
-        // calculate distance between two points
-        int Distance(Point src, Point dst)
+        // initialize change tracking regions
+        void InitializeRegions()
         {
-            return this->Distance(src.X, src.Y, dst.X, dst.Y);
+            this->Regions = Point((this->Dimensions.X + this->RegionSize - 1) / this->RegionSize, (this->Dimensions.Y + this->RegionSize - 1) / this->RegionSize);
+
+            this->Version++;
+
+            this->Versions.assign(this->Regions.X * this->Regions.Y, this->Version);
+
+            this->Dirty.clear();
+
+            this->IsDirty.assign(this->Area(), 0);
         }
 
-        // place a unit in the map tile
-        void Put(Unit::Base &unit, Point point)
+        // region containing the tile (flat index)
+        int Region(int index)
+        {
+            return (index / this->Dimensions.X / this->RegionSize) * this->Regions.X + (index % this->Dimensions.X) / this->RegionSize;
+        }
+
+        // record a change to the tile (flat index)
+        void Touch(int index)
+        {
+            this->Version++;
+
+            this->Versions[this->Region(index)] = this->Version;
+
+            if (!this->IsDirty[index])
+            {
+                this->IsDirty[index] = 1;
+
+                this->Dirty.push_back(index);
+            }
+        }
+
+        // empty the list of changed tiles (after the changes have been handled, e.g. by a MapView)
+        void Clean()
+        {
+            for (auto index : this->Dirty)
+            {
+                this->IsDirty[index] = 0;
+            }
+
+            this->Dirty.clear();
+        }
+
+        // refresh rules view of the tile at index (after editing the tile directly)
+        void Synchronize(int index)
+        {
+            this->Rules.Synchronize(index, this->Tiles[index]);
+
+            this->Touch(index);
+        }
+
+        // refresh rules view of the tile at point (after editing the tile directly)
+        void Synchronize(Point point)
+        {
+            if (this->IsValid(point))
+            {
+                this->Synchronize(this->Index(point));
+            }
+        }
+
+        // rebuild the entire rules view and the unit placements from the tiles
+        void Synchronize()
+        {
+            this->Rules.Resize(this->Area());
+
+            this->Placements.assign(this->Placements.size(), -1);
+
+            for (auto index = 0; index < this->Area(); index++)
+            {
+                this->Synchronize(index);
+
+                this->Tiles[index].Recount();
+
+                for (auto &unit : this->Tiles[index].Units)
+                {
+                    this->Influence(index, unit.Kingdom, 1);
+
+                    if (unit.Id >= 0)
+                    {
+                        if (unit.Id >= int(this->Placements.size()))
+                        {
+                            this->Placements.resize(unit.Id + 1, -1);
+                        }
+
+                        this->Placements[unit.Id] = index;
+                    }
+                }
+            }
+        }
+
+        // update rules view and the zone of control around the tile when a unit of kingdom is added (count = 1) or removed (count = -1)
+        void Influence(int index, Kingdom kingdom, int count)
+        {
+            this->Rules.Occupy(index, kingdom, count);
+
+            if (kingdom != Kingdom::NONE)
+            {
+                this->Rules.Influence(index, kingdom, count);
+
+                for (auto neighbor : this->Adjacent(index))
+                {
+                    this->Rules.Influence(neighbor, kingdom, count);
+                }
+            }
+        }
+
+        // update all unit counters when a unit of kingdom is added (count = 1) or removed (count = -1) from tile
+        void Occupy(int index, Kingdom kingdom, int count)
+        {
+            this->Tiles[index].Occupy(kingdom, count);
+
+            this->Influence(index, kingdom, count);
+
+            this->Touch(index);
+        }
+
+        // set terrain type of tile
+        void SetTerrain(Point point, TerrainType terrain)
+        {
+            if (this->IsValid(point))
+            {
+                (*this)(point).Terrain = terrain;
+
+                this->Synchronize(point);
+            }
+        }
+
+        // set owner of tile
+        void SetOwner(Point point, Kingdom kingdom)
+        {
+            if (this->IsValid(point))
+            {
+                (*this)(point).Owner = kingdom;
+
+                this->Synchronize(point);
+            }
+        }
+
+        // set asset number of tile
+        void SetAsset(Point point, int asset)
+        {
+            if (this->IsValid(point))
+            {
+                (*this)(point).Asset = asset;
+
+                this->Synchronize(point);
+            }
+        }
+
+        // set outline color of tile
+        void SetBorder(Point point, Uint32 color)
+        {
+            if (this->IsValid(point))
+            {
+                (*this)(point).Border = color;
+
+                this->Synchronize(point);
+            }
+        }
+
+        // set background color of tile
+        void SetBackground(Point point, Uint32 color)
+        {
+            if (this->IsValid(point))
+            {
+                (*this)(point).Background = color;
+
+                this->Synchronize(point);
+            }
+        }
+
+        // tile index of the unit, -1 if it is not on the map
+        int Locate(int id)
+        {
+            return id >= 0 && id < int(this->Placements.size()) ? this->Placements[id] : -1;
+        }
+
+        // place a unit in the map tile (a unit already on another tile is removed from it first)
+        void Put(UnitId unit, Point point)
         {
             if (this->IsValid(point) && unit.Id >= 0)
             {
+                auto index = this->Index(point);
+
+                auto current = this->Locate(unit.Id);
+
+                if (current >= 0 && current != index)
+                {
+                    this->Remove(unit.Id, this->Location(current));
+                }
+
+                if (unit.Id >= int(this->Placements.size()))
+                {
+                    this->Placements.resize(unit.Id + 1, -1);
+                }
+
+                this->Placements[unit.Id] = index;
+
                 auto &tile = (*this)(point);
 
                 auto add_unit = true;
@@ -450,15 +1076,33 @@ namespace DarkEmperor
                 if (add_unit)
                 {
                     // add unit
-                    tile.Units.push_back({unit.Id, unit.Type, unit.Kingdom, unit.Mercenary});
+                    tile.Units.push_back(unit);
+
+                    this->Occupy(this->Index(point), unit.Kingdom, 1);
                 }
             }
         }
 
-        // remove a unit from the map tile
-        void Remove(Unit::Base &unit, Point point)
+        // place a unit in the map tile (a unit already on another tile is removed from it first). ids come from Unit::Registry::Add,
+        // units with ids that do not fit in UnitId cannot be placed
+        void Put(Unit::Base &unit, Point point)
         {
-            if (this->IsValid(point) && unit.Id >= 0)
+            if (unit.Id > MaximumUnitId)
+            {
+                std::string error_message = "Invalid unit id: " + std::to_string(unit.Id);
+
+                throw std::invalid_argument(error_message);
+            }
+            else
+            {
+                this->Put(UnitId{std::int16_t(unit.Id), unit.Type, unit.Kingdom, unit.Mercenary}, point);
+            }
+        }
+
+        // remove a unit (id) from the map tile
+        void Remove(int id, Point point)
+        {
+            if (this->IsValid(point) && id >= 0)
             {
                 auto &tile = (*this)(point);
 
@@ -473,7 +1117,7 @@ namespace DarkEmperor
                         auto &search = tile.Units[i];
 
                         // this unit is in the stack on this tile
-                        if (search.Id == unit.Id)
+                        if (search.Id == id)
                         {
                             remove_unit = true;
 
@@ -486,11 +1130,63 @@ namespace DarkEmperor
                     // remove unit if found
                     if (remove_unit && remove_id >= 0 && remove_id < tile.Units.size())
                     {
+                        this->Occupy(this->Index(point), tile.Units[remove_id].Kingdom, -1);
+
                         tile.Units.erase(tile.Units.begin() + remove_id);
+
+                        if (this->Locate(id) == this->Index(point))
+                        {
+                            this->Placements[id] = -1;
+                        }
                     }
                 }
             }
         }
+
+        // remove a unit from the map tile
+        void Remove(Unit::Base &unit, Point point)
+        {
+            this->Remove(unit.Id, point);
+        }
+
+        // remove a unit (id) from whichever tile it is on
+        void Remove(int id)
+        {
+            auto current = this->Locate(id);
+
+            if (current >= 0)
+            {
+                this->Remove(id, this->Location(current));
+            }
+        }
+
+        // remove a unit from whichever tile it is on
+        void Remove(Unit::Base &unit)
+        {
+            this->Remove(unit.Id);
+        }
+
+        // move a unit from its current tile to (point)
+        void Move(UnitId unit, Point point)
+        {
+            if (this->IsValid(point))
+            {
+                this->Remove(unit.Id);
+
+                this->Put(unit, point);
+            }
+        }
+
+        // move a unit from its current tile to (point)
+        void Move(Unit::Base &unit, Point point)
+        {
+            if (this->IsValid(point))
+            {
+                this->Remove(unit);
+
+                this->Put(unit, point);
+            }
+        }
     };
 
     Kingdom FirstKingdom(Stack &units)
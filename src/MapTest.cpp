@@ -78,18 +78,35 @@ namespace DarkEmperor
             }
         }
 
+        // refresh rules view after editing tiles
+        map.Synchronize();
+
         auto units = DarkEmperor::Units();
 
         auto input = Controls::User();
 
         auto done = false;
 
+        // the scene is only rebuilt where the map changes
+        auto view = MapView();
+
+        // terrain is pre-rendered and only redrawn where it changes
+        auto terrain = Graphics::Layer();
+
         while (!done)
         {
-            auto scene = MapScene(map, units, Color::Brown, Color::Red);
+            view.Update(map, units, Color::Brown, Color::Red);
+
+            auto &scene = terrain.Update(graphics, view);
 
             input = Input::WaitForInput(graphics, {scene}, input, true, 25);
 
+            if (input.Reset)
+            {
+                // redraw the chunk textures
+                terrain.Invalidate();
+            }
+
             if (Input::Check(input))
             {
                 if (input.Type == Controls::Type::LOCATION)
@@ -101,6 +118,8 @@ namespace DarkEmperor
             }
         }
 
+        terrain.Destroy();
+
         Asset::ClearTextures();
 
         Graphics::Quit(graphics);
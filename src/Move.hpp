@@ -1,11 +1,25 @@
 #ifndef __MOVE_HPP__
 #define __MOVE_HPP__
 
+#include <limits>
+
 #include "Map.hpp"
+#include "Pool.hpp"
 #include "Random.hpp"
 
 namespace DarkEmperor::Move
 {
+    // search strategies of FindPath (all find paths with the same cost)
+    enum class Strategy
+    {
+        // A* ordered by estimated total cost
+        ASTAR,
+        // A* preferring tiles nearer the destination among those with the same estimated total cost
+        TIE_BREAKING,
+        // A* from both ends, meeting in the middle
+        BIDIRECTIONAL
+    };
+
     // path found by A* algorithm
     class Path
     {
@@ -18,234 +32,1059 @@ namespace DarkEmperor::Move
         Path() {}
     };
 
-    // class representing a node in the graph
-    class Node
+    bool IsPassable(Map &map, Point &location, Stack &units)
+    {
+        auto passable = false;
+
+        if (map.IsValid(location))
+        {
+            auto &tile = map[location];
+
+            auto blocked = tile.IsBlocked();
+
+            auto allowed = tile.IsPassable(units);
+
+            auto fits = tile.CanFitStack(units.size());
+
+            return !blocked && allowed && fits;
+        }
+
+        return passable;
+    }
+
+    // check if tile (flat index) can be entered by a stack of size with unit types in mask
+    bool IsPassable(Map &map, int index, PassageMask mask, int size)
+    {
+        return map.Rules.CanEnter(index, mask, size);
+    }
+
+    // check if tile (flat index) can be entered by the stack
+    bool IsPassable(Map &map, int index, Stack &units)
+    {
+        return Move::IsPassable(map, index, Passage(units), int(units.size()));
+    }
+
+    // check which tiles in row (y) can be entered by the stack (1 = passable)
+    void Passable(Map &map, int y, Stack &units, List<std::uint8_t> &passable)
+    {
+        passable.resize(map.Dimensions.X);
+
+        map.Rules.CanEnter(map.Index(0, y), map.Dimensions.X, Passage(units), int(units.size()), passable.data());
+    }
+
+    // binary min-heap of tile indices with decrease-key support
+    class Heap
     {
     public:
-        int X = -1;
+        // tile indices in heap order
+        List<int> Items = {};
 
-        int Y = -1;
+        // sort key of each tile (indexed by tile)
+        List<long long> Keys = {};
 
-        int Cost = 0;
+        // position of each tile in the heap, -1 if not in the heap (indexed by tile)
+        List<int> Positions = {};
 
-        int Distance = 0;
+        Heap(int size) : Keys(size, 0), Positions(size, -1) {}
 
-        Smart<Move::Node> Parent = nullptr;
+        Heap() {}
+
+        // resize heap to hold (size) tiles
+        void Resize(int size)
+        {
+            this->Clear();
 
-        Node(int x, int y, int cost, Smart<Move::Node> &parent) : X(x), Y(y), Cost(cost), Parent(parent) {}
+            this->Keys.assign(size, 0);
 
-        Node(Point point, int cost, Smart<Move::Node> &parent) : Node(point.X, point.Y, cost, parent) {}
+            this->Positions.assign(size, -1);
+        }
 
-        Node(int x, int y) : X(x), Y(y) {}
+        // remove all tiles from the heap (only touches tiles still in the heap)
+        void Clear()
+        {
+            for (auto item : this->Items)
+            {
+                this->Positions[item] = -1;
+            }
 
-        Node(Point point) : X(point.X), Y(point.Y) {}
+            this->Items.clear();
+        }
 
-        Node() {}
+        bool IsEmpty()
+        {
+            return this->Items.empty();
+        }
 
-        // total cost to traverse this node
-        int CostDistance()
+        int Size()
         {
-            return (this->Cost + this->Distance);
+            return int(this->Items.size());
         }
 
-        // the distance is estimated distance, ignoring obstacles to our target:
-        // how many nodes ignoring obstacles, to get there.
-        //
-        // computes the 2D Manhattan Distance (modified for hex)
-        void SetDistance(Map &map, Smart<Move::Node> &node)
+        // lowest key in the heap (heap must not be empty)
+        long long Top()
         {
-            this->Distance = map.Distance(this->X, this->Y, node->X, node->Y);
+            return this->Keys[this->Items.front()];
         }
-    };
 
-    // list of nodes
-    typedef List<Smart<Move::Node>> Moves;
+        // check if tile is currently in the heap
+        bool Has(int index)
+        {
+            return this->Positions[index] >= 0;
+        }
 
-    Point operator+(const Smart<Node> &node, const Point &p)
-    {
-        return Point(node->X + p.X, node->Y + p.Y);
-    }
+        void Swap(int a, int b)
+        {
+            std::swap(this->Items[a], this->Items[b]);
+
+            this->Positions[this->Items[a]] = a;
+
+            this->Positions[this->Items[b]] = b;
+        }
+
+        // move item towards the root until heap order is restored
+        void Up(int position)
+        {
+            while (position > 0)
+            {
+                auto parent = (position - 1) / 2;
+
+                if (this->Keys[this->Items[position]] >= this->Keys[this->Items[parent]])
+                {
+                    break;
+                }
+
+                this->Swap(position, parent);
+
+                position = parent;
+            }
+        }
+
+        // move item towards the leaves until heap order is restored
+        void Down(int position)
+        {
+            auto size = int(this->Items.size());
+
+            while (true)
+            {
+                auto smallest = position;
+
+                auto left = position * 2 + 1;
+
+                auto right = left + 1;
+
+                if (left < size && this->Keys[this->Items[left]] < this->Keys[this->Items[smallest]])
+                {
+                    smallest = left;
+                }
+
+                if (right < size && this->Keys[this->Items[right]] < this->Keys[this->Items[smallest]])
+                {
+                    smallest = right;
+                }
+
+                if (smallest == position)
+                {
+                    break;
+                }
+
+                this->Swap(position, smallest);
+
+                position = smallest;
+            }
+        }
+
+        // insert tile, or lower its key if it is already in the heap
+        void Push(int index, long long key)
+        {
+            if (this->Has(index))
+            {
+                if (key < this->Keys[index])
+                {
+                    this->Keys[index] = key;
+
+                    this->Up(this->Positions[index]);
+                }
+            }
+            else
+            {
+                this->Keys[index] = key;
+
+                this->Positions[index] = int(this->Items.size());
+
+                this->Items.push_back(index);
+
+                this->Up(this->Positions[index]);
+            }
+        }
 
-    // is the node equal to the point?
-    bool Is(Smart<Move::Node> &a, Point &b)
+        // remove and return the tile with the lowest key
+        int Pop()
+        {
+            auto top = this->Items.front();
+
+            this->Swap(0, int(this->Items.size()) - 1);
+
+            this->Items.pop_back();
+
+            this->Positions[top] = -1;
+
+            if (!this->Items.empty())
+            {
+                this->Down(0);
+            }
+
+            return top;
+        }
+    };
+
+    // cost of moving into location
+    int Cost(Map &map, Point &location)
     {
-        return a->X == b.X && a->Y == b.Y;
+        auto attrition = map[location].Attrition;
+
+        return (attrition == 0 ? 1 : attrition);
     }
 
-    // compare equality between two nodes
-    bool Compare(Smart<Move::Node> &a, Smart<Move::Node> &b)
+    // cost of moving into tile (flat index)
+    int Cost(Map &map, int index)
     {
-        return a->X == b->X && a->Y == b->Y;
+        auto attrition = map.Rules.Attrition[index];
+
+        return (attrition == 0 ? 1 : attrition);
     }
 
-    bool IsPassable(Map &map, Point &location, Stack &units)
+    // reusable search state, sized once from the map dimensions
+    //
+    // entries are only valid if their stamp matches the current generation, so starting a new search does not clear anything
+    class Workspace
     {
-        auto passable = false;
+    public:
+        // current search number
+        unsigned int Generation = 0;
 
-        if (map.IsValid(location))
-        {
-            auto tile = map[location];
+        // generation when the tile was last reached (costs and parents are valid)
+        List<unsigned int> Reached = {};
 
-            auto blocked = tile.IsBlocked();
+        // generation when the tile was last visited (closed)
+        List<unsigned int> Visited = {};
 
-            auto allowed = tile.IsPassable(units);
+        // cost to reach each tile from the source
+        List<int> Costs = {};
 
-            auto fits = tile.CanFitStack(units.size());
+        // previous tile in the path
+        List<int> Parents = {};
 
-            return !blocked && allowed && fits;
+        // tiles to be checked
+        Move::Heap Active = Move::Heap();
+
+        // tiles visited during the current search (in order)
+        List<int> Closed = {};
+
+        // search state from the destination (bidirectional search only, created when first needed)
+        List<Move::Workspace> Backward = {};
+
+        Workspace(int size)
+        {
+            this->Resize(size);
         }
 
-        return passable;
-    }
+        Workspace(Map &map) : Workspace(map.Area()) {}
 
-    Moves Nodes(Map &map, Smart<Move::Node> &current, Smart<Move::Node> &target, Stack &units)
-    {
-        auto traversable = Moves();
+        Workspace() {}
 
-        auto directions = map.Neighbors(current->X, current->Y);
+        int Size()
+        {
+            return int(this->Costs.size());
+        }
 
-        if (map.Dimensions.X > 0 && map.Dimensions.Y > 0)
+        void Resize(int size)
         {
-            for (auto &next : directions)
+            this->Generation = 1;
+
+            this->Reached.assign(size, 0);
+
+            this->Visited.assign(size, 0);
+
+            this->Costs.assign(size, 0);
+
+            this->Parents.assign(size, -1);
+
+            this->Active.Resize(size);
+        }
+
+        // prepare for a new search on the map
+        void Reset(Map &map)
+        {
+            this->Closed.clear();
+
+            if (!this->Backward.empty())
+            {
+                this->Backward.front().Closed.clear();
+            }
+
+            if (this->Size() != map.Area())
             {
-                if (Move::IsPassable(map, next, units))
+                this->Resize(map.Area());
+            }
+            else
+            {
+                this->Active.Clear();
+
+                this->Generation++;
+
+                // stamps wrapped around, clear them once
+                if (this->Generation == 0)
                 {
-                    traversable.push_back(std::make_shared<Move::Node>(next, current->Cost + (map[next].Attrition == 0 ? 1 : map[next].Attrition), current));
+                    std::fill(this->Reached.begin(), this->Reached.end(), 0);
 
-                    traversable.back()->SetDistance(map, target);
+                    std::fill(this->Visited.begin(), this->Visited.end(), 0);
+
+                    this->Generation = 1;
                 }
             }
         }
 
-        return traversable;
-    }
+        // number of tiles visited by the last search (in both directions)
+        int Expanded()
+        {
+            return int(this->Closed.size()) + (this->Backward.empty() ? 0 : int(this->Backward.front().Closed.size()));
+        }
 
-    // get index of node from a list
-    Moves::const_iterator Find(Moves &nodes, Smart<Move::Node> &node)
-    {
-        return DarkEmperor::Find(nodes, node, Move::Compare);
-    }
+        bool IsReached(int index)
+        {
+            return this->Reached[index] == this->Generation;
+        }
 
-    // remove node from list
-    void Remove(Moves &nodes, Smart<Move::Node> &node)
-    {
-        auto found = Move::Find(nodes, node);
+        bool IsVisited(int index)
+        {
+            return this->Visited[index] == this->Generation;
+        }
 
-        if (found != nodes.end())
+        void Visit(int index)
         {
-            nodes.erase(found);
+            this->Visited[index] = this->Generation;
+
+            this->Closed.push_back(index);
         }
-    }
 
-    // check if node is on the list
-    bool In(Moves &nodes, Smart<Move::Node> &node)
-    {
-        return Move::Find(nodes, node) != nodes.end();
-    }
+        // set cost and parent of tile
+        void Reach(int index, int cost, int parent)
+        {
+            this->Reached[index] = this->Generation;
 
-    // find path from src to dst using the A* algorithm
-    Move::Path FindPath(Map &map, Point src, Point dst, Stack &units)
+            this->Costs[index] = cost;
+
+            this->Parents[index] = parent;
+        }
+    };
+
+    // find path from src to dst using the A* algorithm, reusing the workspace and the storage of path
+    //
+    // costs and parents are kept in flat arrays indexed by tile, and the open list is an indexed binary heap.
+    // with tie breaking, tiles with the same estimated total cost are taken in order of distance to the destination,
+    // which avoids expanding whole plateaus of equal cost tiles on open terrain
+    void FindPath(Map &map, Point src, Point dst, Stack &units, Move::Workspace &workspace, Move::Path &path, bool tie_breaking)
     {
-        auto path = Move::Path();
+        path.Points.clear();
+
+        path.Closest = Point(-1, -1);
 
         auto valid = map.IsValid(src) && map.IsValid(dst);
 
         if (map.Dimensions.X > 0 && map.Dimensions.Y > 0 && valid)
         {
-            auto start = std::make_shared<Move::Node>(src);
+            workspace.Reset(map);
+
+            auto &active = workspace.Active;
+
+            // unit types and size of the stack, checked against each tile
+            auto mask = Passage(units);
+
+            auto size = int(units.size());
 
-            auto end = std::make_shared<Move::Node>(dst);
+            auto start = map.Index(src);
 
-            start->SetDistance(map, end);
+            auto end = map.Index(dst);
 
-            // list of nodes to be checked
-            auto active = Moves();
+            auto min_distance = map.IndexDistance(start, end);
 
-            // list of nodes already visited
-            auto visited = Moves();
+            // keys are (estimated total cost * scale + distance to destination) with tie breaking. distances are at most X + Y
+            auto scale = tie_breaking ? (long long)(map.Dimensions.X + map.Dimensions.Y + 1) : 1LL;
 
-            active.push_back(start);
+            auto ties = tie_breaking ? 1LL : 0LL;
 
-            auto min_distance = map.Distance(src, dst);
+            workspace.Reach(start, 0, -1);
+
+            active.Push(start, min_distance * scale + min_distance * ties);
 
             path.Closest = src;
 
-            while (!active.empty())
+            while (!active.IsEmpty())
             {
-                // sort based on CostDistance
-                std::sort(active.begin(), active.end(), [](Smart<Move::Node> &src, Smart<Move::Node> &dst)
-                          { return src->CostDistance() < dst->CostDistance(); });
-
-                auto check = active.front();
+                auto check = active.Pop();
 
-                if (Move::Compare(check, end))
+                if (check == end)
                 {
-                    // we found the destination and we can be sure (because of the sort order above)
-                    // that it's the most low cost option.
-                    auto node = check;
-
-                    while (node)
+                    // we found the destination and it is the lowest cost option (it has the lowest key in the heap)
+                    for (auto node = check; node != -1; node = workspace.Parents[node])
                     {
-                        path.Points.push_back(Point(node->X, node->Y));
-
-                        node = node->Parent;
+                        path.Points.push_back(map.Location(node));
                     }
 
                     // reverse list of coordinates so path leads from src to dst
                     std::reverse(path.Points.begin(), path.Points.end());
 
-                    return path;
+                    return;
                 }
 
-                visited.push_back(check);
+                workspace.Visit(check);
 
-                auto test = Point(check->X, check->Y);
-
-                auto dist = map.Distance(test, dst);
+                auto dist = map.IndexDistance(check, end);
 
                 // check if this is closest point to destination
                 if (dist < min_distance)
                 {
-                    path.Closest = test;
+                    path.Closest = map.Location(check);
 
                     min_distance = dist;
                 }
 
-                Move::Remove(active, check);
+                for (auto node : map.Adjacent(check))
+                {
+                    // we have already visited this node so we don't need to do so again!
+                    if (workspace.IsVisited(node) || !Move::IsPassable(map, node, mask, size))
+                    {
+                        continue;
+                    }
+
+                    auto cost = workspace.Costs[check] + Move::Cost(map, node);
 
-                auto nodes = Move::Nodes(map, check, end, units);
+                    // new node, or a cheaper way to reach a node that is already on the active list
+                    if (!workspace.IsReached(node) || cost < workspace.Costs[node])
+                    {
+                        workspace.Reach(node, cost, check);
+
+                        auto distance = map.IndexDistance(node, end);
+
+                        active.Push(node, (cost + distance) * scale + distance * ties);
+                    }
+                }
+            }
+        }
+    }
 
-                for (auto &node : nodes)
+    // find path from src to dst with A* searches from both ends, reusing the workspace and the storage of path
+    //
+    // the search stops when the estimated cost on either side is no lower than the cheapest path found where the searches meet.
+    // if there is no path, the forward search continues until all reachable tiles are visited so that path.Closest is the same as FindPath
+    void FindPathBidirectional(Map &map, Point src, Point dst, Stack &units, Move::Workspace &workspace, Move::Path &path)
+    {
+        path.Points.clear();
+
+        path.Closest = Point(-1, -1);
+
+        auto valid = map.IsValid(src) && map.IsValid(dst);
+
+        if (map.Dimensions.X > 0 && map.Dimensions.Y > 0 && valid)
+        {
+            if (workspace.Backward.empty())
+            {
+                workspace.Backward.resize(1);
+            }
+
+            auto &forward = workspace;
+
+            auto &backward = workspace.Backward.front();
+
+            forward.Reset(map);
+
+            backward.Reset(map);
+
+            auto mask = Passage(units);
+
+            auto size = int(units.size());
+
+            auto start = map.Index(src);
+
+            auto end = map.Index(dst);
+
+            auto min_distance = map.IndexDistance(start, end);
+
+            path.Closest = src;
+
+            if (start == end)
+            {
+                path.Points.push_back(src);
+
+                return;
+            }
+
+            // cost of the cheapest path found so far and the tile where both searches meet
+            auto best = std::numeric_limits<long long>::max();
+
+            auto meet = -1;
+
+            forward.Reach(start, 0, -1);
+
+            forward.Active.Push(start, min_distance);
+
+            // the destination must be entered, the source is only left
+            if (Move::IsPassable(map, end, mask, size))
+            {
+                backward.Reach(end, 0, -1);
+
+                backward.Active.Push(end, min_distance);
+            }
+
+            auto expand_forward = [&]()
+            {
+                auto check = forward.Active.Pop();
+
+                forward.Visit(check);
+
+                auto dist = map.IndexDistance(check, end);
+
+                if (dist < min_distance)
                 {
-                    // we have already visited this node so we don't need to do so again!
-                    if (Move::In(visited, node))
+                    path.Closest = map.Location(check);
+
+                    min_distance = dist;
+                }
+
+                for (auto node : map.Adjacent(check))
+                {
+                    if (forward.IsVisited(node) || !Move::IsPassable(map, node, mask, size))
                     {
                         continue;
                     }
 
-                    // it's already in the active list, but that's OK, maybe this new node has a better value (e.g. We might zigzag earlier but this is now straighter).
-                    if (Move::In(active, node))
+                    auto cost = forward.Costs[check] + Move::Cost(map, node);
+
+                    if (!forward.IsReached(node) || cost < forward.Costs[node])
                     {
-                        auto existing = *Move::Find(active, node);
+                        forward.Reach(node, cost, check);
+
+                        forward.Active.Push(node, cost + map.IndexDistance(node, end));
 
-                        if (existing->CostDistance() > node->CostDistance())
+                        if (backward.IsReached(node) && cost + backward.Costs[node] < best)
                         {
-                            Move::Remove(active, existing);
+                            best = cost + backward.Costs[node];
 
-                            active.push_back(node);
+                            meet = node;
                         }
                     }
-                    else
+                }
+            };
+
+            auto expand_backward = [&]()
+            {
+                auto check = backward.Active.Pop();
+
+                backward.Visit(check);
+
+                // paths never pass through the source
+                if (check == start)
+                {
+                    return;
+                }
+
+                // moving from a neighbor into this tile
+                auto step = Move::Cost(map, check);
+
+                for (auto node : map.Adjacent(check))
+                {
+                    if (backward.IsVisited(node) || (node != start && !Move::IsPassable(map, node, mask, size)))
+                    {
+                        continue;
+                    }
+
+                    auto cost = backward.Costs[check] + step;
+
+                    if (!backward.IsReached(node) || cost < backward.Costs[node])
                     {
-                        // we've never seen this node before so add it to the list.
-                        active.push_back(node);
+                        backward.Reach(node, cost, check);
+
+                        backward.Active.Push(node, cost + map.IndexDistance(start, node));
+
+                        if (forward.IsReached(node) && cost + forward.Costs[node] < best)
+                        {
+                            best = cost + forward.Costs[node];
+
+                            meet = node;
+                        }
                     }
                 }
+            };
+
+            while (!forward.Active.IsEmpty())
+            {
+                auto searching = !backward.Active.IsEmpty();
+
+                if (forward.Active.Top() >= best || (searching && backward.Active.Top() >= best))
+                {
+                    break;
+                }
+
+                // expand the smaller frontier
+                if (searching && backward.Active.Size() < forward.Active.Size())
+                {
+                    expand_backward();
+                }
+                else
+                {
+                    expand_forward();
+                }
             }
+
+            if (meet >= 0)
+            {
+                for (auto node = meet; node != -1; node = forward.Parents[node])
+                {
+                    path.Points.push_back(map.Location(node));
+                }
+
+                std::reverse(path.Points.begin(), path.Points.end());
+
+                for (auto node = backward.Parents[meet]; node != -1; node = backward.Parents[node])
+                {
+                    path.Points.push_back(map.Location(node));
+                }
+            }
+        }
+    }
+
+    // find path from src to dst using the selected search strategy, reusing the workspace and the storage of path
+    void FindPath(Map &map, Point src, Point dst, Stack &units, Move::Workspace &workspace, Move::Path &path, Move::Strategy strategy)
+    {
+        if (strategy == Move::Strategy::BIDIRECTIONAL)
+        {
+            Move::FindPathBidirectional(map, src, dst, units, workspace, path);
+        }
+        else
+        {
+            Move::FindPath(map, src, dst, units, workspace, path, strategy == Move::Strategy::TIE_BREAKING);
         }
+    }
+
+    // find path from src to dst using the A* algorithm, reusing the workspace and the storage of path
+    void FindPath(Map &map, Point src, Point dst, Stack &units, Move::Workspace &workspace, Move::Path &path)
+    {
+        Move::FindPath(map, src, dst, units, workspace, path, false);
+    }
+
+    // find path from src to dst using the A* algorithm and a reusable workspace
+    Move::Path FindPath(Map &map, Point src, Point dst, Stack &units, Move::Workspace &workspace)
+    {
+        auto path = Move::Path();
+
+        Move::FindPath(map, src, dst, units, workspace, path);
 
         return path;
     }
+
+    // find path from src to dst using the A* algorithm
+    Move::Path FindPath(Map &map, Point src, Point dst, Stack &units)
+    {
+        auto workspace = Move::Workspace(map);
+
+        return Move::FindPath(map, src, dst, units, workspace);
+    }
+
+    // tiles a stack can reach from a source within a movement budget (fields are indexed by tile)
+    class Range
+    {
+    public:
+        Point Source = Point(-1, -1);
+
+        // maximum total movement cost
+        int Budget = 0;
+
+        // cost to reach each tile, -1 if not reachable within the budget
+        List<int> Costs = {};
+
+        // previous tile on the cheapest path, -1 if none
+        List<int> Parents = {};
+
+        // reachable tiles, in order of increasing cost
+        List<int> Reached = {};
+
+        Range() {}
+
+        bool IsReachable(Map &map, Point point)
+        {
+            return map.IsValid(point) && map.Index(point) < this->Costs.size() && this->Costs[map.Index(point)] >= 0;
+        }
+
+        // cheapest path from the source to point (empty if not reachable)
+        Points Path(Map &map, Point point)
+        {
+            auto path = Points();
+
+            if (this->IsReachable(map, point))
+            {
+                for (auto node = map.Index(point); node != -1; node = this->Parents[node])
+                {
+                    path.push_back(map.Location(node));
+                }
+
+                std::reverse(path.begin(), path.end());
+            }
+
+            return path;
+        }
+    };
+
+    // find all tiles reachable from src within budget using Dijkstra's algorithm (same passability and costs as FindPath)
+    void Reachable(Map &map, Point src, Stack &units, int budget, Move::Workspace &workspace, Move::Range &range)
+    {
+        range.Source = src;
+
+        range.Budget = budget;
+
+        range.Costs.assign(map.Area(), -1);
+
+        range.Parents.assign(map.Area(), -1);
+
+        range.Reached.clear();
+
+        if (map.Dimensions.X > 0 && map.Dimensions.Y > 0 && map.IsValid(src) && budget >= 0)
+        {
+            workspace.Reset(map);
+
+            auto &active = workspace.Active;
+
+            // unit types and size of the stack, checked against each tile
+            auto mask = Passage(units);
+
+            auto size = int(units.size());
+
+            auto start = map.Index(src);
+
+            workspace.Reach(start, 0, -1);
+
+            active.Push(start, 0);
+
+            while (!active.IsEmpty())
+            {
+                auto check = active.Pop();
+
+                workspace.Visit(check);
+
+                range.Costs[check] = workspace.Costs[check];
+
+                range.Parents[check] = workspace.Parents[check];
+
+                range.Reached.push_back(check);
+
+                for (auto node : map.Adjacent(check))
+                {
+                    if (workspace.IsVisited(node) || !Move::IsPassable(map, node, mask, size))
+                    {
+                        continue;
+                    }
+
+                    auto cost = workspace.Costs[check] + Move::Cost(map, node);
+
+                    if (cost <= budget && (!workspace.IsReached(node) || cost < workspace.Costs[node]))
+                    {
+                        workspace.Reach(node, cost, check);
+
+                        active.Push(node, cost);
+                    }
+                }
+            }
+        }
+    }
+
+    // find all tiles reachable from src within budget
+    Move::Range Reachable(Map &map, Point src, Stack &units, int budget)
+    {
+        auto workspace = Move::Workspace(map);
+
+        auto range = Move::Range();
+
+        Move::Reachable(map, src, units, budget, workspace, range);
+
+        return range;
+    }
+
+    // path finding request (for batch path finding)
+    class Request
+    {
+    public:
+        Point Source = Point(-1, -1);
+
+        Point Destination = Point(-1, -1);
+
+        // units in the stack being moved
+        Stack Units = {};
+
+        Request(Point src, Point dst, Stack &units) : Source(src), Destination(dst), Units(units) {}
+
+        Request() {}
+    };
+
+    typedef List<Move::Request> Requests;
+
+    // find paths for all requests in parallel using one workspace per worker. paths are returned in request order
+    //
+    // the map is only read during the searches, so it must not be modified until this returns
+    List<Move::Path> FindPaths(Map &map, Move::Requests &requests, Pool::Base &pool, List<Move::Workspace> &workspaces)
+    {
+        auto paths = List<Move::Path>(requests.size());
+
+        if (workspaces.size() < pool.Workers())
+        {
+            workspaces.resize(pool.Workers());
+        }
+
+        pool.Run(int(requests.size()), [&](int task, int worker)
+                 {
+                     auto &request = requests[task];
+
+                     Move::FindPath(map, request.Source, request.Destination, request.Units, workspaces[worker], paths[task]); });
+
+        return paths;
+    }
+
+    // find paths for all requests in parallel. paths are returned in request order
+    List<Move::Path> FindPaths(Map &map, Move::Requests &requests, Pool::Base &pool)
+    {
+        auto workspaces = List<Move::Workspace>(pool.Workers());
+
+        return Move::FindPaths(map, requests, pool, workspaces);
+    }
+
+    // path cache key (endpoints and movement signature of the stack)
+    class Key
+    {
+    public:
+        int Source = -1;
+
+        int Destination = -1;
+
+        PassageMask Mask = 0;
+
+        int Size = 0;
+
+        Key(int src, int dst, PassageMask mask, int size) : Source(src), Destination(dst), Mask(mask), Size(size) {}
+
+        Key() {}
+
+        bool operator==(const Key &key) const
+        {
+            return this->Source == key.Source && this->Destination == key.Destination && this->Mask == key.Mask && this->Size == key.Size;
+        }
+
+        class Hash
+        {
+        public:
+            std::size_t operator()(const Key &key) const
+            {
+                auto hash = std::uint64_t(std::uint32_t(key.Source)) * 0x9E3779B97F4A7C15ULL;
+
+                hash ^= (std::uint64_t(std::uint32_t(key.Destination)) << 32 | (std::uint64_t(key.Mask) << 16) | std::uint64_t(key.Size & 0xFFFF)) + (hash << 6) + (hash >> 2);
+
+                return std::size_t(hash);
+            }
+        };
+    };
+
+    // cached path and the parts of the map it depends on
+    class Entry
+    {
+    public:
+        Move::Path Path = Move::Path();
+
+        // map version when the path was found
+        unsigned int Version = 0;
+
+        // map regions read by the search (the tiles visited and their neighbors)
+        List<int> Regions = {};
+
+        Entry() {}
+    };
+
+    // path cache in front of FindPath
+    //
+    // entries stay valid until one of the map regions read by the search changes (see Map::Touch). not thread-safe
+    class Cache
+    {
+    public:
+        UnorderedMap<Move::Key, Move::Entry, Move::Key::Hash> Entries = {};
+
+        // maximum number of entries (the cache is cleared when full)
+        int Capacity = 4096;
+
+        // paths returned from the cache
+        int Hits = 0;
+
+        // paths not in the cache
+        int Misses = 0;
+
+        // paths in the cache that had to be found again because the map changed
+        int Stale = 0;
+
+        // search state for cache misses
+        Move::Workspace Search = Move::Workspace();
+
+        // used to collect regions without duplicates
+        List<unsigned int> Marks = {};
+
+        unsigned int Mark = 0;
+
+        Cache(int capacity) : Capacity(capacity) {}
+
+        Cache() {}
+
+        void Clear()
+        {
+            this->Entries.clear();
+        }
+
+        // forget statistics
+        void Reset()
+        {
+            this->Hits = 0;
+
+            this->Misses = 0;
+
+            this->Stale = 0;
+        }
+
+        // fraction of requests returned from the cache
+        double HitRate()
+        {
+            auto total = this->Hits + this->Misses + this->Stale;
+
+            return total > 0 ? double(this->Hits) / double(total) : 0.0;
+        }
+
+        // check if none of the regions read when the entry was created have changed since
+        bool IsValid(Map &map, Move::Entry &entry)
+        {
+            auto valid = true;
+
+            if (entry.Version != map.Version)
+            {
+                for (auto region : entry.Regions)
+                {
+                    if (map.Versions[region] > entry.Version)
+                    {
+                        valid = false;
+
+                        break;
+                    }
+                }
+            }
+
+            return valid;
+        }
+
+        // record the regions read by the last search
+        void Record(Map &map, Move::Entry &entry)
+        {
+            if (this->Marks.size() != map.Versions.size())
+            {
+                this->Marks.assign(map.Versions.size(), 0);
+
+                this->Mark = 0;
+            }
+
+            this->Mark++;
+
+            if (this->Mark == 0)
+            {
+                std::fill(this->Marks.begin(), this->Marks.end(), 0);
+
+                this->Mark = 1;
+            }
+
+            entry.Regions.clear();
+
+            auto mark = [&](int index)
+            {
+                auto region = map.Region(index);
+
+                if (this->Marks[region] != this->Mark)
+                {
+                    this->Marks[region] = this->Mark;
+
+                    entry.Regions.push_back(region);
+                }
+            };
+
+            for (auto index : this->Search.Closed)
+            {
+                mark(index);
+
+                for (auto neighbor : map.Adjacent(index))
+                {
+                    mark(neighbor);
+                }
+            }
+
+            entry.Version = map.Version;
+        }
+
+        // find path from src to dst, using the cached path if nothing it depends on has changed
+        void FindPath(Map &map, Point src, Point dst, Stack &units, Move::Path &path)
+        {
+            if (!map.IsValid(src) || !map.IsValid(dst))
+            {
+                Move::FindPath(map, src, dst, units, this->Search, path);
+
+                return;
+            }
+
+            auto key = Move::Key(map.Index(src), map.Index(dst), Passage(units), int(units.size()));
+
+            auto found = this->Entries.find(key);
+
+            if (found != this->Entries.end() && this->IsValid(map, found->second))
+            {
+                this->Hits++;
+
+                path = found->second.Path;
+            }
+            else
+            {
+                if (found == this->Entries.end())
+                {
+                    this->Misses++;
+
+                    if (this->Entries.size() >= this->Capacity)
+                    {
+                        this->Clear();
+                    }
+
+                    found = this->Entries.emplace(key, Move::Entry()).first;
+                }
+                else
+                {
+                    this->Stale++;
+                }
+
+                auto &entry = found->second;
+
+                Move::FindPath(map, src, dst, units, this->Search, entry.Path);
+
+                this->Record(map, entry);
+
+                path = entry.Path;
+            }
+        }
+
+        // find path from src to dst, using the cached path if nothing it depends on has changed
+        Move::Path FindPath(Map &map, Point src, Point dst, Stack &units)
+        {
+            auto path = Move::Path();
+
+            this->FindPath(map, src, dst, units, path);
+
+            return path;
+        }
+    };
 }
 
 #endif
@@ -0,0 +1,254 @@
+#ifndef __POOL_HPP__
+#define __POOL_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "Templates.hpp"
+
+namespace DarkEmperor::Pool
+{
+    // work function called for each task (task number, worker number)
+    typedef std::function<void(int, int)> Task;
+
+    // range of tasks (First to Last - 1) owned by a worker
+    class Queue
+    {
+    public:
+        std::mutex Mutex;
+
+        int First = 0;
+
+        int Last = 0;
+
+        Queue() {}
+    };
+
+    // persistent pool of worker threads. the calling thread takes part as worker 0
+    //
+    // each batch is split evenly between the workers. a worker that runs out of tasks steals half of the remaining tasks of another worker
+    class Base
+    {
+    public:
+        // worker threads (1 to Workers() - 1)
+        List<std::thread> Threads = {};
+
+        // tasks of each worker (in the current batch)
+        List<Pool::Queue> Queues;
+
+        std::mutex Mutex;
+
+        // signals workers that a new batch is available (or that the pool is stopping)
+        std::condition_variable Wake;
+
+        // signals the caller that all workers have finished the batch
+        std::condition_variable Finished;
+
+        // current work function
+        Task Work = nullptr;
+
+        // number of times tasks were taken from another worker
+        std::atomic<int> Steals = 0;
+
+        // number of worker threads still busy with the current batch
+        int Busy = 0;
+
+        // batch number, used by workers to detect new work
+        int Batch = 0;
+
+        bool Stop = false;
+
+        Base(int workers) : Queues(std::max(1, workers))
+        {
+            for (auto worker = 1; worker < workers; worker++)
+            {
+                this->Threads.emplace_back([this, worker]()
+                                           { this->Loop(worker); });
+            }
+        }
+
+        Base() : Base(int(std::thread::hardware_concurrency())) {}
+
+        Base(const Base &) = delete;
+
+        Base &operator=(const Base &) = delete;
+
+        ~Base()
+        {
+            {
+                std::unique_lock<std::mutex> lock(this->Mutex);
+
+                this->Stop = true;
+            }
+
+            this->Wake.notify_all();
+
+            for (auto &thread : this->Threads)
+            {
+                thread.join();
+            }
+        }
+
+        // number of workers (including the calling thread)
+        int Workers()
+        {
+            return int(this->Threads.size()) + 1;
+        }
+
+        // take the next task of the worker, -1 if none left
+        int Take(int worker)
+        {
+            auto &queue = this->Queues[worker];
+
+            std::unique_lock<std::mutex> lock(queue.Mutex);
+
+            return queue.First < queue.Last ? queue.First++ : -1;
+        }
+
+        // take half of the remaining tasks of another worker and return the first one, -1 if there are none left anywhere
+        int Steal(int worker)
+        {
+            auto task = -1;
+
+            for (auto offset = 1; offset < this->Workers() && task < 0; offset++)
+            {
+                auto &victim = this->Queues[(worker + offset) % this->Workers()];
+
+                auto first = 0;
+
+                auto last = 0;
+
+                {
+                    std::unique_lock<std::mutex> lock(victim.Mutex);
+
+                    auto remaining = victim.Last - victim.First;
+
+                    if (remaining > 0)
+                    {
+                        last = victim.Last;
+
+                        first = last - (remaining + 1) / 2;
+
+                        victim.Last = first;
+                    }
+                }
+
+                if (last > first)
+                {
+                    auto &queue = this->Queues[worker];
+
+                    std::unique_lock<std::mutex> lock(queue.Mutex);
+
+                    queue.First = first + 1;
+
+                    queue.Last = last;
+
+                    task = first;
+
+                    this->Steals++;
+                }
+            }
+
+            return task;
+        }
+
+        // run tasks until there are none left
+        void Execute(int worker)
+        {
+            while (true)
+            {
+                auto task = this->Take(worker);
+
+                if (task < 0)
+                {
+                    task = this->Steal(worker);
+                }
+
+                if (task < 0)
+                {
+                    break;
+                }
+
+                this->Work(task, worker);
+            }
+        }
+
+        // worker thread main loop
+        void Loop(int worker)
+        {
+            auto batch = 0;
+
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(this->Mutex);
+
+                    this->Wake.wait(lock, [&]()
+                                    { return this->Stop || this->Batch != batch; });
+
+                    if (this->Stop)
+                    {
+                        break;
+                    }
+
+                    batch = this->Batch;
+                }
+
+                this->Execute(worker);
+
+                {
+                    std::unique_lock<std::mutex> lock(this->Mutex);
+
+                    this->Busy--;
+
+                    if (this->Busy == 0)
+                    {
+                        this->Finished.notify_one();
+                    }
+                }
+            }
+        }
+
+        // run tasks (0 to tasks - 1) on all workers and wait for them to finish
+        void Run(int tasks, Task work)
+        {
+            {
+                std::unique_lock<std::mutex> lock(this->Mutex);
+
+                this->Work = work;
+
+                // split tasks evenly between workers
+                for (auto worker = 0; worker < this->Workers(); worker++)
+                {
+                    auto &queue = this->Queues[worker];
+
+                    std::unique_lock<std::mutex> queue_lock(queue.Mutex);
+
+                    queue.First = int((long long)tasks * worker / this->Workers());
+
+                    queue.Last = int((long long)tasks * (worker + 1) / this->Workers());
+                }
+
+                this->Busy = int(this->Threads.size());
+
+                this->Batch++;
+            }
+
+            this->Wake.notify_all();
+
+            this->Execute(0);
+
+            std::unique_lock<std::mutex> lock(this->Mutex);
+
+            this->Finished.wait(lock, [&]()
+                                { return this->Busy == 0; });
+
+            this->Work = nullptr;
+        }
+    };
+}
+
+#endif
@@ -41,6 +41,9 @@ namespace DarkEmperor
         // texture associated with the element
         SDL_Texture *Texture = nullptr;
 
+        // top-left of the image within its texture (packed assets share a texture page)
+        Point Source = Point(0, 0);
+
         // background color, 0 if none
         Uint32 Background = 0;
 
@@ -74,6 +77,8 @@ namespace DarkEmperor
         {
             Asset::Size(this->Texture, &this->Dimensions.X, &this->Dimensions.Y);
         }
+
+        Element(Asset::Handle asset, Point location) : Location(location), Dimensions(asset.Dimensions), Texture(asset.Texture), Source(asset.Location) {}
     };
 
     typedef List<Element> Elements;
@@ -134,9 +139,10 @@ namespace DarkEmperor
         return element;
     }
 
-    void AddTerrainFeatures(Scene &scene, TerrainType terrain, Point location)
+    // terrain feature (e.g. cities, ports) centered at location. the element has no texture if the terrain has no feature
+    Element TerrainFeature(TerrainType terrain, Point location)
     {
-        SDL_Texture *texture = nullptr;
+        auto texture = Asset::Handle();
 
         switch (terrain)
         {
@@ -175,17 +181,19 @@ namespace DarkEmperor
             break;
         }
 
-        if (texture)
+        auto feature = Element();
+
+        if (texture.Texture)
         {
-            auto feature = Element();
+            // set texture and the location of the image within it
+            feature.Texture = texture.Texture;
 
-            // set texture
-            feature.Texture = texture;
+            feature.Source = texture.Location;
 
-            // get texture dimensions
-            auto terrain_w = Asset::Width(texture);
+            // get image dimensions
+            auto terrain_w = texture.Dimensions.X;
 
-            auto terrain_h = Asset::Height(texture);
+            auto terrain_h = texture.Dimensions.Y;
 
             feature.TextureBounds = terrain_h;
 
@@ -195,271 +203,477 @@ namespace DarkEmperor
             feature.Dimensions = Point(terrain_w, terrain_h);
 
             feature.Shape = Shape::BOX;
+        }
 
+        return feature;
+    }
+
+    void AddTerrainFeatures(Scene &scene, TerrainType terrain, Point location)
+    {
+        auto feature = DarkEmperor::TerrainFeature(terrain, location);
+
+        if (feature.Texture)
+        {
             scene.Add(feature);
         }
     }
 
-    Scene MapScene(Map &map, Units &units, Uint32 background = 0, Uint32 highlight = 0)
+    // number of scene elements reserved for each tile (hex, terrain feature, outline, stack box, stack banner, stack texture)
+    const int TileSlots = 6;
+
+    // map scene that is built once for each view, after which only the elements of tiles that changed (see Map::Dirty) are rebuilt
+    class MapView
     {
-        auto scene = Scene();
+    public:
+        DarkEmperor::Scene Scene = DarkEmperor::Scene();
 
-        scene.Background = background;
+        // map settings the scene was built with
+        Point Dimensions = Point(-1, -1);
 
-        // precalculate hex (on-screen) coordinates and offset
-        auto hex_vertices = DarkEmperor::Vertices(Point(0, 0), map.Size, map.Flat);
+        Point View = Point(-1, -1);
 
-        auto offset_hex = Points();
+        Point Limit = Point(-1, -1);
 
-        auto min_x = hex_vertices[0].X;
+        Point Draw = Point(-1, -1);
 
-        auto min_y = hex_vertices[0].Y;
+        int Size = 0;
 
-        for (auto i = 0; i < hex_vertices.size(); i++)
-        {
-            min_x = std::min(min_x, hex_vertices[i].X);
+        bool Flat = false;
 
-            min_y = std::min(min_y, hex_vertices[i].Y);
-        }
+        Uint32 Highlight = 0;
+
+        // hex (on-screen) coordinates centered at (0, 0)
+        Points Vertices = {};
+
+        // hex coordinates relative to the top-left corner of the hex (for textured hexes)
+        Points Corner = {};
+
+        // first element of each tile in the scene (indexed by tile), -1 if the tile is outside the view
+        List<int> Slots = {};
+
+        // number of tiles rebuilt by the last update
+        int Rebuilt = 0;
 
-        for (auto i = 0; i < hex_vertices.size(); i++)
+        // incremented whenever the whole scene is built
+        unsigned int Builds = 0;
+
+        // incremented whenever any element of the scene changes
+        unsigned int Version = 0;
+
+        // terrain, asset and colors of each tile when its elements were last built
+        List<TerrainType> Terrains = {};
+
+        List<int> Assets = {};
+
+        List<Uint32> Backgrounds = {};
+
+        List<Uint32> Borders = {};
+
+        // tiles whose terrain elements (hex, terrain feature, outline) have changed since the last build. emptied by whoever caches the terrain (e.g. Graphics::Layer)
+        List<int> Repaint = {};
+
+        MapView() {}
+
+        // check if the scene no longer matches the map's view
+        bool IsStale(Map &map, Uint32 highlight)
         {
-            offset_hex.push_back(hex_vertices[i] - Point(min_x, min_y));
+            return this->Dimensions != map.Dimensions || this->View != map.View || this->Limit != map.Limit || this->Draw != map.Draw || this->Size != map.Size || this->Flat != map.Flat || this->Highlight != highlight;
         }
 
-        for (auto y = map.View.Y; y < map.View.Y + map.Limit.Y; y++)
+        // center of the tile on screen (without map.Draw)
+        Point Center(Map &map, Point coordinates)
         {
+            auto point = coordinates - map.View;
+
+            auto cx = 0;
+
             auto cy = 0;
 
-            for (auto x = map.View.X; x < map.View.X + map.Limit.X; x++)
+            // calculate hex center locations
+            if (map.Flat)
+            {
+                auto hex_offset = DarkEmperor::Scale / 2.0 * (point.X % 2 + 1);
+
+                cy = int((DarkEmperor::Scale * point.Y + hex_offset) * map.Size);
+
+                cx = int(point.X * DarkEmperor::Offset * map.Size);
+            }
+            else
+            {
+                auto hex_offset = DarkEmperor::Scale / 2.0 * (point.Y % 2 + 1);
+
+                cx = int((DarkEmperor::Scale * point.X + hex_offset) * map.Size);
+
+                cy = int(point.Y * DarkEmperor::Offset * map.Size);
+            }
+
+            return Point(cx, cy);
+        }
+
+        // rebuild the elements of the tile (flat index, must be in the view)
+        void Refresh(Map &map, Units &units, int index)
+        {
+            auto &tile = map.At(index);
+
+            auto center = this->Center(map, tile.Point);
+
+            auto cx = center.X;
+
+            auto cy = center.Y;
+
+            auto offset = map.Draw + center;
+
+            auto slot = this->Scene.Elements.begin() + this->Slots[index];
+
+            auto hex = Element();
+
+            auto terrain = Asset::Handle();
+
+            if (tile.Asset != Asset::NONE)
             {
-                auto &tile = map[Point(x, y)];
+                terrain = Asset::Get(tile.Asset);
 
-                auto point = tile.Point - map.View;
+                hex.Texture = terrain.Texture;
 
-                auto cx = 0;
+                hex.Source = terrain.Location;
+            }
 
-                auto texture_offset = Point(0, 0);
+            hex.Shape = Shape::HEX;
+
+            if (hex.Texture)
+            {
+                // set texture dimensions
+                auto terrain_w = terrain.Dimensions.X;
+
+                auto terrain_h = terrain.Dimensions.Y;
 
-                // calculate hex center locations
                 if (map.Flat)
                 {
-                    auto hex_offset = DarkEmperor::Scale / 2.0 * (point.X % 2 + 1);
+                    terrain_w = Utilities::ClipValue(map.Size * 2, 0, terrain_w);
 
-                    cy = int((DarkEmperor::Scale * point.Y + hex_offset) * map.Size);
-
-                    cx = int(point.X * DarkEmperor::Offset * map.Size);
+                    // pad
+                    terrain_h = Utilities::ClipValue(int(map.Size * DarkEmperor::Scale + 1), 0, terrain_h);
                 }
                 else
                 {
-                    auto hex_offset = DarkEmperor::Scale / 2.0 * (point.Y % 2 + 1);
-
-                    cx = int((DarkEmperor::Scale * point.X + hex_offset) * map.Size);
+                    // pad
+                    terrain_w = Utilities::ClipValue(int(map.Size * DarkEmperor::Scale + 1), 0, terrain_w);
 
-                    cy = int(point.Y * DarkEmperor::Offset * map.Size);
+                    terrain_h = Utilities::ClipValue(map.Size * 2, 0, terrain_h);
                 }
 
-                auto offset = map.Draw + Point(cx, cy);
+                // calculate terrain tile offsets (to center it within the hex)
+                auto terrain_x = cx - terrain_w / 2;
 
-                auto hex = Element();
+                auto terrain_y = cy - terrain_h / 2;
 
-                if (tile.Asset != Asset::NONE)
-                {
-                    hex.Texture = Asset::Get(tile.Asset);
-                }
+                hex.Hex = this->Corner;
 
-                hex.Shape = Shape::HEX;
+                hex.LocationOffset = map.Draw + Point(terrain_x, terrain_y);
+            }
+            else
+            {
+                // set hex colors
+                hex.Background = tile.Background;
 
-                if (hex.Texture)
-                {
-                    // set texture dimensions
-                    auto terrain_w = Asset::Width(hex.Texture);
+                hex.Border = tile.Border;
 
-                    auto terrain_h = Asset::Height(hex.Texture);
+                // add hex outline / background
+                hex.Hex = DarkEmperor::Add(this->Vertices, offset);
+            }
 
-                    if (map.Flat)
-                    {
-                        terrain_w = Utilities::ClipValue(map.Size * 2, 0, terrain_w);
+            // set hex orientation
+            hex.Flat = map.Flat;
 
-                        // pad
-                        terrain_h = Utilities::ClipValue(int(map.Size * DarkEmperor::Scale + 1), 0, terrain_h);
-                    }
-                    else
+            // hex (background textures/colors)
+            slot[0] = hex;
+
+            // terrain features (e.g. cities, ports)
+            slot[1] = DarkEmperor::TerrainFeature(tile.Terrain, offset);
+
+            // outline (on textured hex)
+            slot[2] = Element();
+
+            if (hex.Texture && tile.Border != 0)
+            {
+                auto &outline = slot[2];
+
+                outline.Shape = Shape::HEX;
+
+                outline.Border = tile.Border;
+
+                outline.Hex = DarkEmperor::Add(this->Vertices, offset);
+
+                // set hex orientation
+                outline.Flat = map.Flat;
+            }
+
+            // unit/stack icon
+            slot[3] = Element();
+
+            slot[4] = Element();
+
+            slot[5] = Element();
+
+            if (tile.Units.size() > 0)
+            {
+                auto stack = Element();
+
+                auto texture = Asset::Handle();
+
+                auto first_unit = -1;
+
+                auto first_asset = Asset::NONE;
+
+                auto assets = 0;
+
+                for (auto &tile_unit : tile.Units)
+                {
+                    if (tile_unit.Id >= 0 && tile_unit.Id < units.size())
                     {
-                        // pad
-                        terrain_w = Utilities::ClipValue(int(map.Size * DarkEmperor::Scale + 1), 0, terrain_w);
+                        auto &unit = units[tile_unit.Id];
 
-                        terrain_h = Utilities::ClipValue(map.Size * 2, 0, terrain_h);
+                        if (unit.Type != UnitType::NONE && unit.Asset != Asset::NONE)
+                        {
+                            if (first_asset == Asset::NONE)
+                            {
+                                first_asset = unit.Asset;
+
+                                first_unit = tile_unit.Id;
+                            }
+
+                            assets++;
+                        }
                     }
+                }
 
-                    // calculate terrain tile offsets (to center it within the hex)
-                    auto terrain_x = cx - terrain_w / 2;
+                auto colors = ColorScheme{0, 0};
 
-                    auto terrain_y = cy - terrain_h / 2;
+                // get the best texture and color scheme
+                if (assets > 1)
+                {
+                    texture = Asset::Get("MULTIPLE UNITS");
 
-                    hex.Hex = offset_hex;
+                    colors = Unit::GetColors(Kingdom::MULTIPLE);
+                }
+                else if (first_unit != -1 && first_asset != Asset::NONE)
+                {
+                    texture = Asset::Get(first_asset);
 
-                    hex.LocationOffset = map.Draw + Point(terrain_x, terrain_y);
+                    colors = Unit::GetColors(units[first_unit]);
                 }
-                else
+
+                // box background
+                slot[3] = ShapeElement(map, center, Shape::BOX, colors);
+
+                // circle banner
+                slot[4] = ShapeElement(map, center, Shape::CIRCLE, colors);
+
+                // unit/units texture
+                if (texture.Texture)
                 {
-                    // set hex colors
-                    hex.Background = tile.Background;
+                    stack.Texture = texture.Texture;
+
+                    stack.Source = texture.Location;
+
+                    // get image dimensions
+                    auto texture_w = texture.Dimensions.X;
+
+                    auto texture_h = texture.Dimensions.Y;
 
-                    hex.Border = tile.Border;
+                    auto texture_x = cx - texture_w / 2;
 
-                    // add hex outline / background
-                    hex.Hex = DarkEmperor::Add(hex_vertices, offset);
+                    auto texture_y = cy - texture_h / 2;
+
+                    stack.Location = map.Draw + Point(texture_x, texture_y);
+
+                    stack.Dimensions = Point(texture_w, texture_h);
                 }
 
-                // set hex orientation
-                hex.Flat = map.Flat;
+                slot[5] = stack;
+            }
 
-                // add hex (background textures/colors)
-                scene.Add(hex);
+            // the terrain elements only need to be redrawn if the terrain, asset or colors have changed
+            if (this->Terrains[index] != tile.Terrain || this->Assets[index] != tile.Asset || this->Backgrounds[index] != tile.Background || this->Borders[index] != tile.Border)
+            {
+                this->Terrains[index] = tile.Terrain;
 
-                // add terrain features (e.g. cities, ports)
-                DarkEmperor::AddTerrainFeatures(scene, tile.Terrain, offset);
+                this->Assets[index] = tile.Asset;
 
-                // add outline (on textured hex)
-                if (hex.Texture && tile.Border != 0)
-                {
-                    auto outline = Element();
+                this->Backgrounds[index] = tile.Background;
 
-                    outline.Shape = Shape::HEX;
+                this->Borders[index] = tile.Border;
 
-                    outline.Border = tile.Border;
+                this->Repaint.push_back(index);
+            }
 
-                    outline.Hex = DarkEmperor::Add(hex_vertices, offset);
+            this->Version++;
+        }
 
-                    // set hex orientation
-                    outline.Flat = map.Flat;
+        // build the elements and controls of all tiles in the view
+        void Build(Map &map, Units &units, Uint32 background, Uint32 highlight)
+        {
+            auto &scene = this->Scene;
 
-                    scene.Add(outline);
-                }
+            scene = DarkEmperor::Scene();
 
-                // add unit/stack icon to the scene
-                if (tile.Units.size() > 0)
-                {
-                    auto stack = Element();
+            scene.Background = background;
 
-                    auto first = -1;
+            this->Dimensions = map.Dimensions;
 
-                    auto first_asset = Asset::NONE;
+            this->View = map.View;
 
-                    auto assets = 0;
+            this->Limit = map.Limit;
 
-                    for (auto &tile_unit : tile.Units)
-                    {
-                        if (tile_unit.Id >= 0 && tile_unit.Id < units.size())
-                        {
-                            auto &unit = units[tile_unit.Id];
+            this->Draw = map.Draw;
 
-                            if (unit.Type != UnitType::NONE && unit.Asset != Asset::NONE)
-                            {
-                                if (first_asset == Asset::NONE)
-                                {
-                                    first_asset = unit.Asset;
+            this->Size = map.Size;
 
-                                    first = tile_unit.Id;
-                                }
+            this->Flat = map.Flat;
 
-                                assets++;
-                            }
-                        }
-                    }
+            this->Highlight = highlight;
 
-                    auto colors = ColorScheme{0, 0};
+            // precalculate hex (on-screen) coordinates and offset
+            this->Vertices = DarkEmperor::Vertices(Point(0, 0), map.Size, map.Flat);
 
-                    // get the best texture and color scheme
-                    if (assets > 1)
-                    {
-                        stack.Texture = Asset::Get("MULTIPLE UNITS");
+            this->Corner.clear();
 
-                        colors = Unit::GetColors(Kingdom::MULTIPLE);
-                    }
-                    else if (first != -1 && first_asset != Asset::NONE)
-                    {
-                        stack.Texture = Asset::Get(first_asset);
+            auto min_x = this->Vertices[0].X;
 
-                        colors = Unit::GetColors(units[first]);
-                    }
+            auto min_y = this->Vertices[0].Y;
 
-                    // add box background
-                    scene.Add(ShapeElement(map, Point(cx, cy), Shape::BOX, colors));
+            for (auto i = 0; i < this->Vertices.size(); i++)
+            {
+                min_x = std::min(min_x, this->Vertices[i].X);
 
-                    // add circle banner
-                    scene.Add(ShapeElement(map, Point(cx, cy), Shape::CIRCLE, colors));
+                min_y = std::min(min_y, this->Vertices[i].Y);
+            }
 
-                    // add unit/units texture
-                    if (stack.Texture)
-                    {
-                        // get texture dimensions
-                        auto texture_w = Asset::Width(stack.Texture);
+            for (auto i = 0; i < this->Vertices.size(); i++)
+            {
+                this->Corner.push_back(this->Vertices[i] - Point(min_x, min_y));
+            }
 
-                        auto texture_h = Asset::Height(stack.Texture);
+            this->Slots.assign(map.Area(), -1);
 
-                        auto texture_x = cx - texture_w / 2;
+            this->Terrains.assign(map.Area(), TerrainType::NONE);
 
-                        auto texture_y = cy - texture_h / 2;
+            this->Assets.assign(map.Area(), Asset::NONE);
 
-                        stack.Location = map.Draw + Point(texture_x, texture_y);
+            this->Backgrounds.assign(map.Area(), 0);
 
-                        stack.Dimensions = Point(texture_w, texture_h);
-                    }
+            this->Borders.assign(map.Area(), 0);
 
-                    scene.Add(stack);
-                }
+            this->Repaint.clear();
+
+            this->Rebuilt = 0;
+
+            this->Builds++;
+
+            for (auto y = map.View.Y; y < map.View.Y + map.Limit.Y; y++)
+            {
+                for (auto x = map.View.X; x < map.View.X + map.Limit.X; x++)
+                {
+                    auto index = map.Index(x, y);
+
+                    auto offset = map.Draw + this->Center(map, Point(x, y));
+
+                    // reserve elements for the tile
+                    this->Slots[index] = int(scene.Elements.size());
+
+                    scene.Elements.resize(scene.Elements.size() + TileSlots);
+
+                    this->Refresh(map, units, index);
+
+                    this->Rebuilt++;
+
+                    // setup control definition
+                    auto control = Controls::Base();
+
+                    // current id
+                    auto id = int(scene.Controls.size());
 
-                // setup control definition
-                auto control = Controls::Base();
+                    auto dx = (x - map.View.X);
 
-                // current id
-                auto id = int(scene.Controls.size());
+                    auto dy = (y - map.View.Y);
 
-                auto dx = (x - map.View.X);
+                    // set references to other controls (id)
+                    auto lt = dx > 0 ? id - 1 : id;
 
-                auto dy = (y - map.View.Y);
+                    auto rt = dx < map.Limit.X - 1 ? id + 1 : id;
 
-                // set references to other controls (id)
-                auto lt = dx > 0 ? id - 1 : id;
+                    auto up = dy > 0 ? id - map.Limit.X : id;
 
-                auto rt = dx < map.Limit.X - 1 ? id + 1 : id;
+                    auto dn = dy < map.Limit.Y - 1 ? id + map.Limit.X : id;
 
-                auto up = dy > 0 ? id - map.Limit.X : id;
+                    control.Id = {id, lt, rt, up, dn};
 
-                auto dn = dy < map.Limit.Y - 1 ? id + map.Limit.X : id;
+                    control.Type = Controls::Type::LOCATION;
 
-                control.Id = {id, lt, rt, up, dn};
+                    // setup control hit box
+                    control.Location = offset - map.Size / 2;
 
-                control.Type = Controls::Type::LOCATION;
+                    control.Dimensions = Point(map.Size, map.Size);
 
-                // setup control hit box
-                control.Location = offset - map.Size / 2;
+                    // set color of hex outline
+                    control.Highlight = highlight;
 
-                control.Dimensions = Point(map.Size, map.Size);
+                    // set flag indicating control refers to map coordinates
+                    control.OnMap = true;
 
-                // set color of hex outline
-                control.Highlight = highlight;
+                    // set actual location on map and position of hex outline on screen
+                    control.Map.Coordinates = Point(x, y);
 
-                // set flag indicating control refers to map coordinates
-                control.OnMap = true;
+                    control.Map.Center = offset;
 
-                // set actual location on map and position of hex outline on screen
-                control.Map.Coordinates = Point(x, y);
+                    control.Map.Flat = map.Flat;
 
-                control.Map.Center = offset;
+                    control.Map.Size = map.Size;
 
-                control.Map.Flat = map.Flat;
+                    // add control to scene
+                    scene.Add(control);
+                }
+            }
+        }
+
+        // bring the scene up to date with the map (rebuilds everything only if the view has changed) and mark the map as clean
+        DarkEmperor::Scene &Update(Map &map, Units &units, Uint32 background = 0, Uint32 highlight = 0)
+        {
+            if (this->IsStale(map, highlight))
+            {
+                this->Build(map, units, background, highlight);
+            }
+            else
+            {
+                this->Rebuilt = 0;
+
+                for (auto index : map.Dirty)
+                {
+                    if (this->Slots[index] >= 0)
+                    {
+                        this->Refresh(map, units, index);
 
-                control.Map.Size = map.Size;
+                        this->Rebuilt++;
+                    }
+                }
 
-                // add control to scene
-                scene.Add(control);
+                this->Scene.Background = background;
             }
+
+            map.Clean();
+
+            return this->Scene;
         }
+    };
+
+    // build the scene for the map's current view (use MapView to keep the scene between frames)
+    Scene MapScene(Map &map, Units &units, Uint32 background = 0, Uint32 highlight = 0)
+    {
+        auto view = MapView();
+
+        view.Build(map, units, background, highlight);
 
-        return scene;
+        return view.Scene;
     }
 }
 
@@ -0,0 +1,289 @@
+#include <chrono>
+#include <iostream>
+
+#include "Game.hpp"
+#include "Pool.hpp"
+#include "Utilities.hpp"
+
+// headless game simulation (rules only, does not use SDL)
+namespace DarkEmperor::Simulation
+{
+    typedef std::chrono::high_resolution_clock Clock;
+
+    // elapsed time in milliseconds
+    double Elapsed(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // time spent in each phase of the games (milliseconds)
+    class Timings
+    {
+    public:
+        double Setup = 0.0;
+
+        double Movement = 0.0;
+
+        double Revenue = 0.0;
+
+        Timings() {}
+
+        double Total()
+        {
+            return this->Setup + this->Movement + this->Revenue;
+        }
+
+        void Add(Simulation::Timings &timings)
+        {
+            this->Setup += timings.Setup;
+
+            this->Movement += timings.Movement;
+
+            this->Revenue += timings.Revenue;
+        }
+    };
+
+    // a simulated game with its own session and random number generator
+    class Base
+    {
+    public:
+        Game::Session Session = Game::Session();
+
+        Random::Base Generator;
+
+        Move::Workspace Workspace = Move::Workspace();
+
+        Move::Range Range = Move::Range();
+
+        // revenue at the end of the last turn
+        Game::Ledger Ledger = Game::Ledger();
+
+        int Turns = 0;
+
+        Simulation::Timings Timings = Simulation::Timings();
+
+        Base(int seed) : Generator(seed) {}
+
+        // set up random terrain, owners and units on the map of the session (tile settings for Loslon are not loaded yet)
+        void Setup(int units)
+        {
+            const List<TerrainType> terrains = {
+                TerrainType::SEA, TerrainType::SEA, TerrainType::SEA,
+                TerrainType::SETTLED, TerrainType::SETTLED, TerrainType::SETTLED, TerrainType::SETTLED,
+                TerrainType::MOUNTAIN, TerrainType::MOUNTAIN,
+                TerrainType::RIVER,
+                TerrainType::COASTAL, TerrainType::COASTAL,
+                TerrainType::CITY,
+                TerrainType::PORT,
+                TerrainType::HOLY_PLACE,
+                TerrainType::MAGIC_HEX};
+
+            auto start = Simulation::Clock::now();
+
+            auto &random = this->Generator;
+
+            auto &map = this->Session.Loslon;
+
+            for (auto index = 0; index < map.Area(); index++)
+            {
+                auto &tile = map.At(index);
+
+                tile.Terrain = terrains[random.NextInt(0, int(terrains.size()) - 1)];
+
+                tile.StackLimit = DarkEmperor::StackLimit(tile.Terrain);
+
+                tile.Attrition = (tile.Terrain == TerrainType::MOUNTAIN ? 2 : (tile.Terrain == TerrainType::RIVER ? 1 : 0));
+
+                tile.CityValue = tile.IsCity() ? random.NextInt(1, 3) : 0;
+
+                tile.Owner = Kingdom(random.NextInt(0, int(Kingdom::ZOLAHAURESLOR)));
+            }
+
+            map.Synchronize();
+
+            for (auto i = 0; i < units; i++)
+            {
+                auto point = Point(random.NextInt(0, map.Dimensions.X - 1), random.NextInt(0, map.Dimensions.Y - 1));
+
+                auto type = map[point].Terrain == TerrainType::SEA ? UnitType::NAVAL : UnitType::GROUND;
+
+                auto handle = this->Session.Add(Unit::Base(type, Kingdom(random.NextInt(0, int(Kingdom::ZOLAHAURESLOR))), 1, 1, Asset::NONE, "Simulation"));
+
+                this->Session.Put(handle, point);
+            }
+
+            this->Timings.Setup += Simulation::Elapsed(start);
+        }
+
+        // move every unit to a random tile within its movement budget, then collect revenue
+        void Turn(int budget)
+        {
+            auto start = Simulation::Clock::now();
+
+            auto &map = this->Session.Loslon;
+
+            auto &registry = this->Session.Registry;
+
+            for (auto id = 0; id < registry.Size(); id++)
+            {
+                auto handle = registry.Find(id);
+
+                if (!registry.IsValid(handle))
+                {
+                    continue;
+                }
+
+                auto location = map.Location(this->Session.Locate(handle));
+
+                auto stack = Stack{registry.Identify(id)};
+
+                Move::Reachable(map, location, stack, budget, this->Workspace, this->Range);
+
+                this->Session.Put(handle, map.Location(this->Range.Reached[this->Generator.NextInt(0, int(this->Range.Reached.size()) - 1)]));
+            }
+
+            this->Timings.Movement += Simulation::Elapsed(start);
+
+            start = Simulation::Clock::now();
+
+            this->Ledger = Game::Revenue(map);
+
+            this->Timings.Revenue += Simulation::Elapsed(start);
+
+            this->Turns++;
+        }
+
+        // play a whole game
+        void Play(int turns, int units, int budget)
+        {
+            this->Setup(units);
+
+            for (auto turn = 0; turn < turns; turn++)
+            {
+                this->Turn(budget);
+            }
+        }
+    };
+
+    // aggregate results of a batch of games
+    class Results
+    {
+    public:
+        int Games = 0;
+
+        int Turns = 0;
+
+        // wall clock time of the batch (milliseconds)
+        double Time = 0.0;
+
+        // time spent in each phase, summed over all games
+        Simulation::Timings Timings = Simulation::Timings();
+
+        // sum of production, losses and unit locations at the end of every game (the same for a given seed regardless of the number of workers)
+        long long Checksum = 0;
+
+        // tasks taken from other workers
+        int Steals = 0;
+
+        Results() {}
+    };
+
+    // play (games) independent games in parallel. game i is seeded with (seed + i)
+    Simulation::Results Batch(int games, int turns, int units, int budget, int seed, Pool::Base &pool)
+    {
+        auto results = Simulation::Results();
+
+        auto timings = List<Simulation::Timings>(games);
+
+        auto turns_played = List<int>(games, 0);
+
+        auto checksums = List<long long>(games, 0);
+
+        auto steals = int(pool.Steals);
+
+        auto start = Simulation::Clock::now();
+
+        pool.Run(games, [&](int task, int worker)
+                 {
+                     auto game = Simulation::Base(seed + task);
+
+                     game.Play(turns, units, budget);
+
+                     for (auto kingdom = 0; kingdom <= int(Kingdom::ZOLAHAURESLOR); kingdom++)
+                     {
+                         checksums[task] += game.Ledger.Production[kingdom] + game.Ledger.Lost[kingdom];
+                     }
+
+                     for (auto id = 0; id < game.Session.Registry.Size(); id++)
+                     {
+                         checksums[task] += game.Session.Locate(game.Session.Registry.Find(id));
+                     }
+
+                     timings[task] = game.Timings;
+
+                     turns_played[task] = game.Turns; });
+
+        results.Time = Simulation::Elapsed(start);
+
+        results.Games = games;
+
+        results.Steals = int(pool.Steals) - steals;
+
+        for (auto game = 0; game < games; game++)
+        {
+            results.Turns += turns_played[game];
+
+            results.Timings.Add(timings[game]);
+
+            results.Checksum += checksums[game];
+        }
+
+        return results;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    auto games = argc > 1 ? std::atoi(argv[1]) : 100;
+
+    auto turns = argc > 2 ? std::atoi(argv[2]) : 100;
+
+    auto units = argc > 3 ? std::atoi(argv[3]) : 200;
+
+    auto workers = argc > 4 ? std::atoi(argv[4]) : int(std::thread::hardware_concurrency());
+
+    auto seed = argc > 5 ? std::atoi(argv[5]) : 1985;
+
+    if (games < 1 || turns < 0 || units < 0)
+    {
+        std::cerr << "To Use:" << std::endl
+                  << std::endl
+                  << argv[0] << " [games] [turns] [units] [workers] [seed]" << std::endl;
+
+        exit(1);
+    }
+
+    auto pool = DarkEmperor::Pool::Base(workers);
+
+    auto results = DarkEmperor::Simulation::Batch(games, turns, units, 4, seed, pool);
+
+    auto seconds = results.Time / 1000.0;
+
+    auto &timings = results.Timings;
+
+    auto total = timings.Total() > 0.0 ? timings.Total() : 1.0;
+
+    std::cerr << "Games: " << results.Games << ", turns: " << results.Turns << ", units: " << units << ", workers: " << pool.Workers() << ", steals: " << results.Steals << std::endl;
+
+    std::cerr << "Time: " << results.Time << " ms, " << (seconds > 0.0 ? results.Games / seconds : 0.0) << " games/sec, " << (seconds > 0.0 ? results.Turns / seconds : 0.0) << " turns/sec" << std::endl;
+
+    std::cerr << "Setup: " << timings.Setup << " ms (" << timings.Setup * 100.0 / total << "%)" << std::endl;
+
+    std::cerr << "Movement: " << timings.Movement << " ms (" << timings.Movement * 100.0 / total << "%)" << std::endl;
+
+    std::cerr << "Revenue: " << timings.Revenue << " ms (" << timings.Revenue * 100.0 / total << "%)" << std::endl;
+
+    std::cerr << "Checksum: " << results.Checksum << std::endl;
+
+    return 0;
+}
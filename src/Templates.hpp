@@ -2,6 +2,8 @@
 #define __TEMPLATES_HPP__
 
 #include <algorithm>
+#include <array>
+#include <initializer_list>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -20,6 +22,154 @@ namespace DarkEmperor
     template <typename T>
     using Reference = std::reference_wrapper<T>;
 
+    // vector that keeps up to (N) items inline and only moves them to the heap when it grows larger
+    template <typename T, int N>
+    class SmallList
+    {
+    public:
+        typedef T value_type;
+
+        typedef T *iterator;
+
+        typedef const T *const_iterator;
+
+        // items (if there are at most N)
+        std::array<T, N> Items = {};
+
+        // items (if there are more than N)
+        List<T> Spill = {};
+
+        int Count = 0;
+
+        SmallList(std::initializer_list<T> items)
+        {
+            for (auto &item : items)
+            {
+                this->push_back(item);
+            }
+        }
+
+        SmallList() {}
+
+        bool IsInline() const
+        {
+            return this->Count <= N;
+        }
+
+        T *data()
+        {
+            return this->IsInline() ? this->Items.data() : this->Spill.data();
+        }
+
+        const T *data() const
+        {
+            return this->IsInline() ? this->Items.data() : this->Spill.data();
+        }
+
+        std::size_t size() const
+        {
+            return std::size_t(this->Count);
+        }
+
+        bool empty() const
+        {
+            return this->Count == 0;
+        }
+
+        iterator begin()
+        {
+            return this->data();
+        }
+
+        iterator end()
+        {
+            return this->data() + this->Count;
+        }
+
+        const_iterator begin() const
+        {
+            return this->data();
+        }
+
+        const_iterator end() const
+        {
+            return this->data() + this->Count;
+        }
+
+        T &operator[](std::size_t index)
+        {
+            return this->data()[index];
+        }
+
+        const T &operator[](std::size_t index) const
+        {
+            return this->data()[index];
+        }
+
+        T &front()
+        {
+            return this->data()[0];
+        }
+
+        T &back()
+        {
+            return this->data()[this->Count - 1];
+        }
+
+        void clear()
+        {
+            this->Spill.clear();
+
+            this->Count = 0;
+        }
+
+        void push_back(const T &item)
+        {
+            if (this->Count < N)
+            {
+                this->Items[this->Count] = item;
+            }
+            else
+            {
+                // move everything to the heap
+                if (this->Count == N)
+                {
+                    this->Spill.assign(this->Items.begin(), this->Items.end());
+                }
+
+                this->Spill.push_back(item);
+            }
+
+            this->Count++;
+        }
+
+        iterator erase(iterator position)
+        {
+            auto index = position - this->begin();
+
+            if (this->IsInline())
+            {
+                std::move(this->Items.begin() + index + 1, this->Items.begin() + this->Count, this->Items.begin() + index);
+            }
+            else
+            {
+                this->Spill.erase(this->Spill.begin() + index);
+
+                // back to inline storage
+                if (this->Count - 1 == N)
+                {
+                    std::copy(this->Spill.begin(), this->Spill.end(), this->Items.begin());
+
+                    this->Spill.clear();
+                }
+            }
+
+            this->Count--;
+
+            return this->begin() + index;
+        }
+    };
+
     // array (vector of vectors)
     template <typename T>
     using Array = List<List<T>>;
@@ -52,8 +202,8 @@ namespace DarkEmperor
     }
 
     // unordered mapping
-    template <typename T, typename R>
-    using UnorderedMap = std::unordered_map<T, R>;
+    template <typename T, typename R, typename H = std::hash<T>>
+    using UnorderedMap = std::unordered_map<T, R, H>;
 
     // find key in map
     template <typename T, typename R>
@@ -1,14 +1,17 @@
 #ifndef __TYPES_HPP__
 #define __TYPES_HPP__
 
+#include <array>
+#include <cstdint>
 #include <vector>
 
+#include "ColorTypes.hpp"
 #include "Templates.hpp"
 
 namespace DarkEmperor
 {
     // terrain
-    enum class TerrainType
+    enum class TerrainType : std::int8_t
     {
         NONE = -1,
         CITY,
@@ -24,7 +27,7 @@ namespace DarkEmperor
         BATTLEFIELD
     };
 
-    enum class UnitType
+    enum class UnitType : std::int8_t
     {
         NONE = -1,
         GROUND,
@@ -40,7 +43,7 @@ namespace DarkEmperor
         FLAME
     };
 
-    enum class RuneType
+    enum class RuneType : std::int8_t
     {
         NONE = -1,
         TERROR,
@@ -55,7 +58,7 @@ namespace DarkEmperor
         SERENITY
     };
 
-    enum class Kingdom
+    enum class Kingdom : std::int8_t
     {
         NONE = -1,
         NECROMANCER,
@@ -72,7 +75,10 @@ namespace DarkEmperor
         MULTIPLE
     };
 
-    enum class Leader
+    // number of kingdom slots (NECROMANCER to MULTIPLE) in arrays indexed by kingdom
+    const int TotalKingdoms = int(Kingdom::MULTIPLE) + 1;
+
+    enum class Leader : std::int8_t
     {
         NONE = -1,
         PADRECH_DAR_CHOIM,
@@ -101,7 +107,7 @@ namespace DarkEmperor
         HOUNDMASTER
     };
 
-    enum class Mercenary
+    enum class Mercenary : std::int8_t
     {
         NONE = -1,
         COS_DOL_COS,
@@ -112,10 +118,13 @@ namespace DarkEmperor
         FERNAN_CONNIVER
     };
 
-    // individual unit id (id, type, kingdom)
+    // largest unit id that fits in UnitId
+    const int MaximumUnitId = 32767;
+
+    // individual unit id (id, type, kingdom), packed into 6 bytes
     struct UnitId
     {
-        int Id = -1;
+        std::int16_t Id = -1;
 
         UnitType Type = UnitType::NONE;
 
@@ -124,8 +133,8 @@ namespace DarkEmperor
         Mercenary Mercenary = Mercenary::NONE;
     };
 
-    // unit id collection
-    typedef List<UnitId> Stack;
+    // unit id collection (stacks rarely exceed the terrain stack limits, so they are kept inline)
+    typedef SmallList<UnitId, 4> Stack;
 
     // for unit-stacking in the map
     struct UnitStack
@@ -155,6 +164,30 @@ namespace DarkEmperor
         {TerrainType::MAGIC_HEX, 4},
         {TerrainType::BATTLEFIELD, 4}};
 
+    // default stack limit of each terrain (indexed by terrain + 1, so that TerrainType::NONE is first)
+    std::array<int, int(TerrainType::BATTLEFIELD) + 2> InitializeStackLimits()
+    {
+        auto limits = std::array<int, int(TerrainType::BATTLEFIELD) + 2>();
+
+        limits.fill(0);
+
+        for (auto &limit : TerrainStackLimits)
+        {
+            limits[int(limit.first) + 1] = limit.second;
+        }
+
+        return limits;
+    }
+
+    // read-only copy of the stack limits (safe to read from several threads)
+    const auto StackLimits = InitializeStackLimits();
+
+    // default stack limit of terrain
+    int StackLimit(TerrainType terrain)
+    {
+        return StackLimits[int(terrain) + 1];
+    }
+
     // player (control) type
     enum class Player
     {
@@ -283,6 +316,66 @@ namespace DarkEmperor
         {TerrainType::MAGIC_HEX, {UnitType::AIR, UnitType::GROUND, UnitType::LEADER}},
         {TerrainType::BATTLEFIELD, {UnitType::AIR, UnitType::GROUND, UnitType::LEADER}}};
 
+    // set of unit types (one bit per unit type)
+    typedef std::uint16_t PassageMask;
+
+    // bit representing the unit type in a passage mask (UnitType::NONE uses the highest bit)
+    PassageMask Passage(UnitType type)
+    {
+        return PassageMask(1 << (type == UnitType::NONE ? 15 : int(type)));
+    }
+
+    // unit types allowed on each terrain (indexed by terrain + 1, so that TerrainType::NONE is first)
+    std::array<PassageMask, int(TerrainType::BATTLEFIELD) + 2> InitializePassage()
+    {
+        auto masks = std::array<PassageMask, int(TerrainType::BATTLEFIELD) + 2>();
+
+        masks.fill(0);
+
+        for (auto &passage : AllowedPassage)
+        {
+            for (auto type : passage.second)
+            {
+                masks[int(passage.first) + 1] |= Passage(type);
+            }
+        }
+
+        return masks;
+    }
+
+    const auto TerrainPassage = InitializePassage();
+
+    // unit types allowed on terrain
+    PassageMask Passage(TerrainType terrain)
+    {
+        return TerrainPassage[int(terrain) + 1];
+    }
+
+    // unit types present in the stack
+    PassageMask Passage(Stack &units)
+    {
+        auto mask = PassageMask(0);
+
+        for (auto &unit : units)
+        {
+            mask |= Passage(unit.Type);
+        }
+
+        return mask;
+    }
+
+    // check if all unit types in mask are allowed by passage
+    bool IsPassable(PassageMask passage, PassageMask mask)
+    {
+        return (passage & mask) == mask;
+    }
+
+    // check if terrain can be traversed by unit type
+    bool IsPassable(TerrainType terrain, UnitType type)
+    {
+        return DarkEmperor::IsPassable(Passage(terrain), Passage(type));
+    }
+
     Points Add(Points &points, Point origin)
     {
         auto translated = Points();
@@ -1,7 +1,13 @@
 #ifndef __UNIT_HPP__
 #define __UNIT_HPP__
 
-#include "Asset.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "AssetTypes.hpp"
+#include "ColorTypes.hpp"
 #include "Types.hpp"
 
 namespace DarkEmperor::Unit
@@ -99,6 +105,293 @@ namespace DarkEmperor::Unit
         Base() {}
     };
 
+    // reference to a unit in the registry (the generation detects ids that have been recycled)
+    struct Handle
+    {
+        int Id = -1;
+
+        unsigned Generation = 0;
+    };
+
+    // unit storage with one array per field (indexed by unit id), so that passes over units only touch the fields they need.
+    // this is the only copy of the units of a session: Get assembles a unit from its fields and Set writes them back
+    class Registry
+    {
+    public:
+        List<UnitType> Types = {};
+
+        List<DarkEmperor::Leader> Leaders = {};
+
+        List<DarkEmperor::Kingdom> Kingdoms = {};
+
+        List<DarkEmperor::Mercenary> Mercenaries = {};
+
+        // magic runes
+        List<RuneType> Runes = {};
+
+        // combat strength
+        List<int> Combat = {};
+
+        // undead combat strength
+        List<int> Undead = {};
+
+        // hero rating
+        List<int> Hero = {};
+
+        // magic strength
+        List<int> Magic = {};
+
+        // asset (texture) ids
+        List<int> Assets = {};
+
+        // flag if the unit is dead and uses undead combat strength
+        List<std::uint8_t> IsUndead = {};
+
+        // flag if magical devices / monsters / weapons have been revealed
+        List<std::uint8_t> Revealed = {};
+
+        // index into Strings
+        List<int> Names = {};
+
+        // incremented every time the id is released
+        List<unsigned> Generations = {};
+
+        // flag if the id is in use
+        List<std::uint8_t> Alive = {};
+
+        // released ids, reused by Add before new ids are allocated
+        List<int> Free = {};
+
+        // interned unit names
+        List<std::string> Strings = {};
+
+        UnorderedMap<std::string, int> Interned = {};
+
+        // number of ids in use
+        int Count = 0;
+
+        Registry() {}
+
+        // index of the name in Strings (adds it if it is new)
+        int Intern(const std::string &name)
+        {
+            auto result = -1;
+
+            auto found = this->Interned.find(name);
+
+            if (found != this->Interned.end())
+            {
+                result = found->second;
+            }
+            else
+            {
+                result = int(this->Strings.size());
+
+                this->Strings.push_back(name);
+
+                this->Interned[name] = result;
+            }
+
+            return result;
+        }
+
+        // number of ids allocated (including released ones)
+        int Size()
+        {
+            return int(this->Alive.size());
+        }
+
+        bool IsAlive(int id)
+        {
+            return id >= 0 && id < this->Size() && this->Alive[id];
+        }
+
+        // check if the handle still refers to the same unit
+        bool IsValid(Handle handle)
+        {
+            return this->IsAlive(handle.Id) && this->Generations[handle.Id] == handle.Generation;
+        }
+
+        Unit::Handle Find(int id)
+        {
+            return this->IsAlive(id) ? Unit::Handle{id, this->Generations[id]} : Unit::Handle();
+        }
+
+        // add unit (reusing a released id if there is one) and return its handle. ids are at most MaximumUnitId so they fit in UnitId
+        // (Map::Put rejects larger ids), the handle is not valid if all of them are in use
+        Unit::Handle Add(Unit::Base &unit)
+        {
+            auto handle = Unit::Handle();
+
+            auto id = -1;
+
+            if (!this->Free.empty())
+            {
+                id = this->Free.back();
+
+                this->Free.pop_back();
+            }
+            else if (this->Size() <= MaximumUnitId)
+            {
+                id = this->Size();
+
+                this->Types.push_back(UnitType::NONE);
+
+                this->Leaders.push_back(DarkEmperor::Leader::NONE);
+
+                this->Kingdoms.push_back(DarkEmperor::Kingdom::NONE);
+
+                this->Mercenaries.push_back(DarkEmperor::Mercenary::NONE);
+
+                this->Runes.push_back(RuneType::NONE);
+
+                this->Combat.push_back(-1);
+
+                this->Undead.push_back(-1);
+
+                this->Hero.push_back(-1);
+
+                this->Magic.push_back(-1);
+
+                this->Assets.push_back(Asset::NONE);
+
+                this->IsUndead.push_back(0);
+
+                this->Revealed.push_back(0);
+
+                this->Names.push_back(-1);
+
+                this->Generations.push_back(0);
+
+                this->Alive.push_back(0);
+            }
+
+            if (id >= 0)
+            {
+                this->Set(id, unit);
+
+                this->Alive[id] = 1;
+
+                this->Count++;
+
+                handle = Unit::Handle{id, this->Generations[id]};
+            }
+
+            return handle;
+        }
+
+        // release the id (handles to it become invalid)
+        void Remove(int id)
+        {
+            if (this->IsAlive(id))
+            {
+                this->Alive[id] = 0;
+
+                this->Generations[id]++;
+
+                this->Free.push_back(id);
+
+                this->Count--;
+            }
+        }
+
+        // write the fields of the unit (the id of the unit is ignored)
+        void Set(int id, Unit::Base &unit)
+        {
+            this->Types[id] = unit.Type;
+
+            this->Leaders[id] = unit.Leader;
+
+            this->Kingdoms[id] = unit.Kingdom;
+
+            this->Mercenaries[id] = unit.Mercenary;
+
+            this->Runes[id] = unit.Rune;
+
+            this->Combat[id] = unit.Combat;
+
+            this->Undead[id] = unit.Undead;
+
+            this->Hero[id] = unit.Hero;
+
+            this->Magic[id] = unit.Magic;
+
+            this->Assets[id] = unit.Asset;
+
+            this->IsUndead[id] = unit.IsUndead ? 1 : 0;
+
+            this->Revealed[id] = unit.Revealed ? 1 : 0;
+
+            this->Names[id] = this->Intern(unit.Name);
+        }
+
+        // assemble the unit from its fields (an empty unit if the id is not in use)
+        Unit::Base Get(int id)
+        {
+            auto unit = Unit::Base();
+
+            if (this->IsAlive(id))
+            {
+                unit.Type = this->Types[id];
+
+                unit.Leader = this->Leaders[id];
+
+                unit.Kingdom = this->Kingdoms[id];
+
+                unit.Mercenary = this->Mercenaries[id];
+
+                unit.Rune = this->Runes[id];
+
+                unit.Id = id;
+
+                unit.Combat = this->Combat[id];
+
+                unit.Undead = this->Undead[id];
+
+                unit.Hero = this->Hero[id];
+
+                unit.Magic = this->Magic[id];
+
+                unit.Asset = this->Assets[id];
+
+                unit.IsUndead = this->IsUndead[id] != 0;
+
+                unit.Revealed = this->Revealed[id] != 0;
+
+                unit.Name = this->Name(id);
+            }
+
+            return unit;
+        }
+
+        std::string &Name(int id)
+        {
+            return this->Strings[this->Names[id]];
+        }
+
+        // unit id used in map stacks
+        UnitId Identify(int id)
+        {
+            return UnitId{std::int16_t(id), this->Types[id], this->Kingdoms[id], this->Mercenaries[id]};
+        }
+
+        // total combat strength of the kingdom's units (undead units use their undead combat strength)
+        int Strength(DarkEmperor::Kingdom kingdom)
+        {
+            auto strength = 0;
+
+            for (auto id = 0; id < this->Size(); id++)
+            {
+                if (this->Alive[id] && this->Kingdoms[id] == kingdom)
+                {
+                    strength += std::max(0, this->IsUndead[id] ? this->Undead[id] : this->Combat[id]);
+                }
+            }
+
+            return strength;
+        }
+    };
+
     // kingdom color scheme mapping
     UnorderedMap<Kingdom, ColorScheme> KingdomColors = {
         {Kingdom::NECROMANCER, {Color::Grey, Color::Grey}},
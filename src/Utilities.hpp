@@ -2,6 +2,7 @@
 #define __UTILITIES_HPP__
 
 #include <algorithm>
+#include <cstring>
 #include <string>
 
 namespace DarkEmperor::Utilities